@@ -0,0 +1,138 @@
+#ifndef MYBANK_ASYNC_AUTHORIZER_H
+#define MYBANK_ASYNC_AUTHORIZER_H
+
+#if !defined(__cpp_impl_coroutine) || !__has_include(<coroutine>)
+#error "async_authorizer.h requires C++20 coroutines"
+#endif
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "process_operations.h"
+
+namespace mybank
+{
+
+// Lazily started coroutine, either awaited by another coroutine or started by its owner
+class task
+{
+public:
+    struct promise_type
+    {
+        std::coroutine_handle<> continuation{ std::noop_coroutine() };
+
+        auto get_return_object() -> task
+        {
+            return task{ std::coroutine_handle<promise_type>::from_promise(*this) };
+        }
+
+        auto initial_suspend() noexcept -> std::suspend_always { return {}; }
+
+        auto final_suspend() noexcept
+        {
+            struct final_awaiter
+            {
+                auto await_ready() noexcept -> bool { return false; }
+
+                auto await_suspend(std::coroutine_handle<promise_type> handle) noexcept -> std::coroutine_handle<>
+                {
+                    return handle.promise().continuation;
+                }
+
+                void await_resume() noexcept {}
+            };
+
+            return final_awaiter{};
+        }
+
+        void return_void() {}
+
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    task(task &&other) noexcept
+            : handle_{ std::exchange(other.handle_, {}) }
+    {
+    }
+
+    task &operator=(task &&) = delete;
+    task(const task &) = delete;
+    task &operator=(const task &) = delete;
+
+    ~task()
+    {
+        if (handle_)
+        {
+            handle_.destroy();
+        }
+    }
+
+    // Runs the coroutine on the calling thread until its first suspension
+    void start()
+    {
+        handle_.resume();
+    }
+
+    auto done() const -> bool
+    {
+        return handle_.done();
+    }
+
+    auto await_ready() const -> bool
+    {
+        return handle_.done();
+    }
+
+    auto await_suspend(std::coroutine_handle<> awaiting) -> std::coroutine_handle<>
+    {
+        handle_.promise().continuation = awaiting;
+        return handle_;
+    }
+
+    void await_resume() {}
+
+private:
+    explicit task(std::coroutine_handle<promise_type> handle)
+            : handle_{ handle }
+    {
+    }
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+// Authorizes the lines of an async source and writes the results to an async sink, where
+//   co_await source.next() yields std::optional<std::string>, std::nullopt ending the stream
+//   co_await sink.write(std::string_view) completes once the output line is consumed
+// Source, sink and authorizer must outlive the task, and the authorizer is not shared with other streams.
+// The stream only holds the coroutine frame and its authorizer between operations,
+// so a single thread can multiplex many mostly idle streams by resuming them as their I/O completes.
+template<typename Source, typename Sink>
+auto authorize_stream(
+        Source &source,
+        Sink &sink,
+        mybank::Authorizer &authorizer)
+        -> task
+{
+    for (;;)
+    {
+        std::optional<std::string> inputLine{ co_await source.next() };
+        if (!inputLine.has_value())
+        {
+            break;
+        }
+
+        const auto output{ authorizer.process(std::string_view{ inputLine.value() }) };
+        if (!output.empty())
+        {
+            co_await sink.write(output);
+        }
+    }
+}
+
+} //namespace mybank
+
+#endif //MYBANK_ASYNC_AUTHORIZER_H
@@ -0,0 +1,82 @@
+#ifndef MYBANK_METRICS_H
+#define MYBANK_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "process_operations.h"
+
+namespace mybank
+{
+
+enum class Metric
+{
+    // Input lines decoded as JSON, whatever the operation
+    OPERATIONS,
+    // Input lines skipped for not being valid JSON
+    INVALID_LINES,
+    // Decoded lines that are neither an account nor a transaction
+    UNKNOWN_OPERATIONS,
+    ACCEPTED_TRANSACTIONS,
+    // Gauges of the valid transactions kept, in the history and in the spend window
+    HISTORY_TRANSACTIONS,
+    SPEND_WINDOW_TRANSACTIONS,
+    // Transactions that expired from the spend window
+    SPEND_WINDOW_EVICTIONS,
+    // Threads of the parallel decode mode left where they were because the system refused their CPUs
+    UNPINNED_THREADS
+};
+
+constexpr std::size_t metricCount{ 8 };
+
+struct metrics_snapshot
+{
+    std::array<int64_t, metricCount> metrics{};
+    // Indexed by Violation
+    std::array<int64_t, violationCount> violations{};
+
+    auto operator[](Metric metric) const -> int64_t { return metrics[static_cast<std::size_t>(metric)]; }
+    auto operator[](Violation violation) const -> int64_t { return violations[static_cast<std::size_t>(violation)]; }
+};
+
+// Counters shared by the authorizers and threads given it in process_options.
+// Each thread adds to one of a few cache line sized shards, picked once per thread,
+// so threads rarely write to the same line, and a snapshot sums the shards.
+class Metrics
+{
+public:
+    Metrics() = default;
+    Metrics(const Metrics &) = delete;
+    Metrics &operator=(const Metrics &) = delete;
+
+    void add(Metric, int64_t count = 1);
+    void add(Violation);
+
+    auto snapshot() const -> metrics_snapshot;
+
+private:
+    static constexpr std::size_t shardCount{ 16 };
+
+    struct alignas(64) shard
+    {
+        std::array<std::atomic<int64_t>, metricCount + violationCount> counters{};
+    };
+
+    auto thread_shard() -> shard &;
+
+    std::array<shard, shardCount> shards_{};
+};
+
+// Snapshot in the Prometheus text exposition format, every metric prefixed with mybank_
+auto to_prometheus(const mybank::metrics_snapshot &) -> std::string;
+
+// Replaces the file with the Prometheus text of a snapshot, writing a temporary file first
+// so a collector reading it (e.g. the node exporter textfile collector) never sees half of it
+auto write_prometheus(const mybank::Metrics &, const std::string &path) -> bool;
+
+} //namespace mybank
+
+#endif //MYBANK_METRICS_H
@@ -0,0 +1,28 @@
+#ifndef MYBANK_NUMA_TOPOLOGY_H
+#define MYBANK_NUMA_TOPOLOGY_H
+
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace mybank
+{
+
+// CPUs of each NUMA node holding any, nodes numbered from 0 in the order listed
+struct numa_topology
+{
+    std::vector<std::vector<int>> nodeCpus{};
+    // Kernel numbers of those nodes, empty for simulated topologies
+    std::vector<int> nodeIds{};
+};
+
+// Topology read from /sys/devices/system/node, a single node with every CPU when it
+// cannot be read (machines without NUMA support, other systems than Linux)
+auto detect_numa_topology() -> mybank::numa_topology;
+
+// Parses a kernel CPU list such as "0-3,8,10-11", std::nullopt when malformed
+auto parse_cpu_list(std::string_view) -> std::optional<std::vector<int>>;
+
+} //namespace mybank
+
+#endif //MYBANK_NUMA_TOPOLOGY_H
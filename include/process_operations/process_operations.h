@@ -5,8 +5,15 @@
 #include <ctime>
 #include <iosfwd>
 #include <iostream>
+#include <limits>
+#include <optional>
 #include <functional>
+#include <map>
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace mybank
 {
@@ -17,9 +24,15 @@ enum class Violation
     ACCOUNT_NOT_ACTIVE,
     DOUBLED_TRANSACTION,
     HIGH_FREQUENCY_SMALL_INTERVAL,
-    INSUFFICIENT_LIMIT
+    INSUFFICIENT_LIMIT,
+    SPEND_VELOCITY,
+    VELOCITY_AMOUNT_LIMIT,
+    VELOCITY_COUNT_LIMIT
 };
 
+// Number of Violation values
+constexpr std::size_t violationCount{ 8 };
+
 struct account
 {
     bool activeAccount;
@@ -34,13 +47,179 @@ struct transaction
     time_t timeInMillis;
 };
 
+// Allocated from the memory resource it was created with, the default one unless an Authorizer backs it with huge pages
+using transaction_history = std::pmr::map<time_t, mybank::transaction>;
+
+// Pages backing the valid transactions history and its index
+enum class HugePages
+{
+    OFF,
+    // Transparent huge pages requested with madvise(MADV_HUGEPAGE)
+    TRANSPARENT,
+    // Pages reserved in the hugetlbfs pool (vm.nr_hugepages), transparent ones when the pool is empty
+    HUGETLBFS
+};
+
+class HugePageArena;
+class Metrics;
+class OperationDecoder;
+class OutputRenderer;
+class WriteAheadLog;
+struct history_index;
+struct numa_topology;
+
+// Limits on the valid transactions within windowMillis up to a new one, the new one included,
+// counting only those matching the rule: at the merchant (any when empty, or each one separately)
+// and with an amount in [minAmount, maxAmount]
+struct velocity_rule
+{
+    std::string merchant{};
+    bool eachMerchant{ false };
+    int64_t minAmount{ std::numeric_limits<int64_t>::min() };
+    int64_t maxAmount{ std::numeric_limits<int64_t>::max() };
+
+    time_t windowMillis{ 10*60*1000 };
+
+    // Exceeded: velocity-count-limit
+    std::size_t maxTransactions{ std::numeric_limits<std::size_t>::max() };
+
+    // Exceeded by the total amount: velocity-amount-limit
+    int64_t maxAmountSum{ std::numeric_limits<int64_t>::max() };
+};
+
+// Largest window accepted for the rules, 1000 years: twice a window, or a window subtracted
+// from a transaction time, stays far inside the range of time_t
+constexpr time_t maxWindowMillis{ 1000LL*365*24*60*60*1000 };
+
+// Parameters of the interval rules, the defaults are the rules described in the README
+struct rule_options
+{
+    // Valid transactions closer than this in time to a new one are checked against it
+    time_t smallIntervalMillis{ 2*60*1000 };
+
+    // Exceeded by the valid transactions in a window of the interval: high-frequency-small-interval
+    std::size_t maxTransactionsSmallInterval{ 2 };
+
+    // Exceeded by the valid transactions with the new one's merchant and amount in a window: doubled-transaction
+    std::size_t maxEqualTransactionsSmallInterval{ 1 };
+
+    std::vector<mybank::velocity_rule> velocityRules{};
+
+    // Exceeded by the total amount of the valid transactions within spendWindowMillis up to a new one,
+    // the new one included: spend-velocity. Disabled when the window is 0.
+    time_t spendWindowMillis{ 0 };
+    int64_t maxSpendInWindow{ std::numeric_limits<int64_t>::max() };
+};
+
+// Reads rule options from a JSON object with any of the rule_options members as keys, velocityRules
+// being an array of objects with velocity_rule members, absent ones keeping their defaults.
+// Returns std::nullopt when the file is not such an object or a window exceeds maxWindowMillis.
+auto load_rule_options(const std::string &path) -> std::optional<mybank::rule_options>;
+
+struct process_options
+{
+    // Accepted state changes are appended to the log when set
+    mybank::WriteAheadLog *wal{ nullptr };
+
+    // When positive, transactions are held in a reorder buffer for this many milliseconds
+    // of transaction time (at most maxWindowMillis) and authorized in time order, output keeps the arrival order
+    time_t reorderLatenessMillis{ 0 };
+    std::size_t reorderCapacity{ 1024 };
+
+    // Overlaps reading/decoding, authorizing and writing on three threads, ignored when reordering
+    bool pipelined{ false };
+    std::size_t pipelineCapacity{ 1024 };
+
+    // When positive, lines are decoded in chunks by this many threads and authorized
+    // in input order by a single committer thread, ignored when reordering or pipelined
+    std::size_t decodeThreads{ 0 };
+    std::size_t decodeChunkLines{ 4096 };
+
+    // When set, the committer is pinned to the NUMA node of the account's memory (the calling thread's
+    // node when the system cannot tell), the calling thread reads on two CPUs of that node until the input
+    // ends, and the decoders go to the nodes planned for them, each node decoding the chunks routed to its
+    // own queue. Threads the system refuses to pin are counted in the metrics. A simulated topology stands
+    // in for the machine's in tests.
+    const mybank::numa_topology *numaTopology{ nullptr };
+
+    mybank::rule_options rules{};
+
+    // Operations, violations and window occupancy are counted when set
+    mybank::Metrics *metrics{ nullptr };
+
+    // Writes only what each operation changed, tagged with its input line number (from 1):
+    //   {"seq":n,"account":{...}} when the account is created
+    //   {"seq":n,"availableLimit":int} when a transaction is accepted
+    //   {"seq":n,"violations":[...]} when an operation is rejected
+    // and nothing for the other lines
+    bool deltaOutput{ false };
+
+    // Keeps the history of an Authorizer in 2 MB pages, fewer TLB entries covering a large history.
+    // Falls back to normal pages when the system has no huge pages to give.
+    mybank::HugePages hugePages{ mybank::HugePages::OFF };
+};
+
+// State owned by an Authorizer
+struct authorizer_state
+{
+    std::optional<mybank::account> account;
+    mybank::transaction_history validTransactions;
+    std::vector<mybank::Violation> violations;
+};
+
+// Authorization engine owning the account, the valid transactions history and reusable
+// input and output buffers, fed whole streams or one operation at a time
+class Authorizer
+{
+public:
+    explicit Authorizer(const mybank::process_options & = {});
+    Authorizer(Authorizer &&) noexcept;
+    Authorizer &operator=(Authorizer &&) noexcept;
+    ~Authorizer();
+
+    // Processes a single input line like process_operations would and returns its output line
+    // with its '\n', empty when the line produces none. The view is valid until the next call.
+    auto process(std::string_view) -> std::string_view;
+
+    // Authorizes a transaction and returns its violations, valid until the next call.
+    // Transactions are ignored until an account is created.
+    auto process(const mybank::transaction &) -> const std::vector<mybank::Violation> &;
+
+    // Processes every line of the input, transactions with the execution mode chosen in the options
+    void process(std::istream &, std::ostream &);
+
+    // Continues from an existing account and history, e.g. a recovered one
+    void restore(const mybank::account &, mybank::transaction_history);
+
+    // Moves the account and history out, leaving the authorizer without an account.
+    // The history returned uses the default memory resource, moved out of the arena with huge pages.
+    auto release_state() -> mybank::authorizer_state;
+
+    auto state() const -> const mybank::authorizer_state &;
+    auto options() const -> const mybank::process_options &;
+
+private:
+    mybank::process_options options_;
+    // Declared before the containers allocated from it, held apart so they keep its address when moved
+    std::unique_ptr<mybank::HugePageArena> arena_;
+    std::unique_ptr<mybank::authorizer_state> state_;
+    std::unique_ptr<mybank::history_index> index_;
+    std::unique_ptr<mybank::OperationDecoder> decoder_;
+    std::unique_ptr<mybank::OutputRenderer> renderer_;
+    uint64_t inputLines_{ 0 };
+    std::string inputLine_{};
+    std::string output_{};
+};
+
 void process_operations(
         std::istream & = std::cin,
-        std::ostream & = std::cout);
+        std::ostream & = std::cout,
+        const mybank::process_options & = {});
 
 auto get_new_account(
         std::istream & = std::cin,
-        std::ostream & = std::cout)
+        std::ostream & = std::cout,
+        const mybank::process_options & = {})
         -> std::optional<mybank::account>;
 
 void process_transactions(
@@ -48,6 +227,13 @@ void process_transactions(
         std::istream & = std::cin,
         std::ostream & = std::cout);
 
+void process_transactions(
+        mybank::account &,
+        mybank::transaction_history &,
+        std::istream &,
+        std::ostream &,
+        const mybank::process_options &);
+
 } //namespace mybank
 
 #endif //MYBANK_PROCESS_OPERATIONS_H
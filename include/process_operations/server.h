@@ -0,0 +1,66 @@
+#ifndef MYBANK_SERVER_H
+#define MYBANK_SERVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "process_operations.h"
+
+namespace mybank
+{
+
+struct server_options
+{
+    // Listens on this Unix domain socket when set, otherwise on 127.0.0.1:tcpPort (0 picks a free port)
+    std::string unixSocketPath;
+    uint16_t tcpPort{ 0 };
+    int backlog{ 128 };
+
+    // A connection sending a longer line (without its newline) is dropped
+    std::size_t maxLineLength{ 1024*1024 };
+
+    // Reading from a connection stops while more output than this waits for it, and resumes once it is below
+    std::size_t outputHighWaterMark{ 1024*1024 };
+
+    // Bytes read from a connection for each readiness event, the rest waits for the next turn of the event loop
+    std::size_t readBudget{ 256*1024 };
+};
+
+// Serves JSON lines over persistent connections from an epoll event loop (Linux only).
+// Every connection feeds the same resident account and history, each operation is answered
+// with the line process_operations would write for it, in the order it was received.
+class AuthorizerServer
+{
+public:
+    static auto open(
+            const server_options &,
+            const process_options & = {})
+            -> std::optional<AuthorizerServer>;
+
+    AuthorizerServer(AuthorizerServer &&) noexcept;
+    AuthorizerServer &operator=(AuthorizerServer &&) noexcept;
+    ~AuthorizerServer();
+
+    // Bound TCP port, 0 when listening on a Unix domain socket
+    auto port() const -> uint16_t;
+
+    // Runs the event loop on the calling thread until stop() is called
+    void run();
+
+    // Can be called from any thread
+    void stop();
+
+private:
+    struct impl;
+
+    explicit AuthorizerServer(std::unique_ptr<impl>);
+
+    std::unique_ptr<impl> impl_;
+};
+
+} //namespace mybank
+
+#endif //MYBANK_SERVER_H
@@ -0,0 +1,73 @@
+#ifndef MYBANK_URING_STREAMS_H
+#define MYBANK_URING_STREAMS_H
+
+#include <cstddef>
+#include <memory>
+#include <streambuf>
+
+#include "process_operations.h"
+
+namespace mybank
+{
+
+struct uring_options
+{
+    // Number of registered buffers, that is reads or writes kept in flight
+    unsigned queueDepth{ 4 };
+    std::size_t bufferSize{ 256*1024 };
+};
+
+// Stream buffer reading a file descriptor through io_uring with registered buffers (Linux only).
+// Regular files keep queueDepth reads in flight at increasing offsets, pipes and sockets one read ahead.
+// Falls back to read(2) when io_uring or its read operations are not available.
+class UringInputStreambuf : public std::streambuf
+{
+public:
+    explicit UringInputStreambuf(int fd, const uring_options & = {});
+    ~UringInputStreambuf() override;
+
+    auto uses_io_uring() const -> bool;
+
+    // Whether the input ended on a read error rather than at its end, only 0 bytes read being the end
+    auto failed() const -> bool;
+
+protected:
+    auto underflow() -> int_type override;
+
+private:
+    struct impl;
+    std::unique_ptr<impl> impl_;
+};
+
+// Stream buffer batching writes to a file descriptor into bufferSize writes submitted through io_uring,
+// several in flight for regular files and one at a time otherwise so the output order is kept.
+// Falls back to write(2) when io_uring or its write operations are not available.
+class UringOutputStreambuf : public std::streambuf
+{
+public:
+    explicit UringOutputStreambuf(int fd, const uring_options & = {});
+    ~UringOutputStreambuf() override;
+
+    auto uses_io_uring() const -> bool;
+
+protected:
+    auto overflow(int_type) -> int_type override;
+    auto sync() -> int override;
+
+private:
+    struct impl;
+    std::unique_ptr<impl> impl_;
+};
+
+// process_operations reading and writing the file descriptors through the io_uring stream buffers.
+// Returns false when reading the input or writing the output failed.
+auto process_operations(
+        int inputFd,
+        int outputFd,
+        const mybank::process_options & = {},
+        const mybank::uring_options & = {})
+        -> bool;
+
+} //namespace mybank
+
+#endif //MYBANK_URING_STREAMS_H
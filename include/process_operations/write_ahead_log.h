@@ -0,0 +1,92 @@
+#ifndef MYBANK_WRITE_AHEAD_LOG_H
+#define MYBANK_WRITE_AHEAD_LOG_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "process_operations.h"
+
+namespace mybank
+{
+
+struct wal_options
+{
+    std::string path;
+    // A group is committed (written and fsync'ed) when either limit is reached, the interval counted
+    // from the oldest pending record and also checked while no records arrive.
+    // 1 record or 0 microseconds syncs every accepted change.
+    std::size_t groupCommitRecords{ 64 };
+    std::chrono::microseconds groupCommitInterval{ 1000 };
+};
+
+// Append-only log of accepted state changes, one JSON line per record:
+// { "seq": int, "account": {...} } or { "seq": int, "transaction": {...} }
+// Records a failed commit could not write or sync stay pending and are retried by the next one.
+// Can be appended to from several threads, the records are numbered in the order they are buffered.
+class WriteAheadLog
+{
+public:
+    // A record torn at the end of an existing log is truncated away, the sequence continues after the
+    // last complete record (or lastSequence when it is higher). std::nullopt when the log cannot be
+    // opened, repaired or its directory synced.
+    static auto open(
+            const wal_options &,
+            uint64_t lastSequence = 0)
+            -> std::optional<WriteAheadLog>;
+
+    WriteAheadLog(WriteAheadLog &&) noexcept;
+    WriteAheadLog &operator=(WriteAheadLog &&) noexcept;
+    WriteAheadLog(const WriteAheadLog &) = delete;
+    WriteAheadLog &operator=(const WriteAheadLog &) = delete;
+    ~WriteAheadLog();
+
+    // false when the group commit the record triggered failed, or the log was moved from
+    auto append(const mybank::account &) -> bool;
+    auto append(const mybank::transaction &) -> bool;
+
+    // false when the pending records could not be written and synced
+    auto commit() -> bool;
+
+    auto sequence() const -> uint64_t;
+
+private:
+    struct impl;
+
+    explicit WriteAheadLog(std::unique_ptr<impl>);
+
+    // The record is the field of that name with the serialized value, numbered under the lock
+    auto append_record(const char *field, const std::string &value) -> bool;
+
+    std::unique_ptr<impl> impl_;
+};
+
+struct recovered_state
+{
+    std::optional<mybank::account> account;
+    mybank::transaction_history validTransactions;
+    uint64_t walSequence;
+};
+
+// Atomically and durably replaces the checkpoint file with the given state,
+// WAL records up to walSequence are then no longer needed for recovery
+auto write_checkpoint(
+        const std::string &path,
+        const mybank::account &,
+        const mybank::transaction_history &,
+        uint64_t walSequence)
+        -> bool;
+
+// Loads the checkpoint (if any) and replays every WAL record written after it, a torn record at the
+// tail of the log is ignored. std::nullopt when the log is corrupted: a record that cannot be read
+// before the tail, or a gap in the sequence.
+auto recover_state(
+        const std::string &checkpointPath,
+        const std::string &walPath)
+        -> std::optional<mybank::recovered_state>;
+
+} //namespace mybank
+
+#endif //MYBANK_WRITE_AHEAD_LOG_H
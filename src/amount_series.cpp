@@ -0,0 +1,37 @@
+#include <algorithm>
+
+#include "amount_series.h"
+
+mybank::AmountSeries::AmountSeries(const allocator_type &allocator)
+        : times_{ allocator },
+          runningTotals_{ allocator }
+{
+}
+
+void mybank::AmountSeries::add(time_t timeInMillis, int64_t amount)
+{
+    const auto position{ static_cast<std::size_t>(
+            std::upper_bound(times_.begin(), times_.end(), timeInMillis) - times_.begin()) };
+    const auto previousTotal{ (position == 0) ? int64_t{ 0 } : runningTotals_[position - 1] };
+
+    times_.insert(times_.begin() + position, timeInMillis);
+    runningTotals_.insert(runningTotals_.begin() + position, previousTotal + amount);
+
+    for (auto later{ position + 1 }; later < runningTotals_.size(); ++later)
+    {
+        runningTotals_[later] += amount;
+    }
+}
+
+auto mybank::AmountSeries::totals(time_t after, time_t last) const -> mybank::window_totals
+{
+    const auto first{ std::upper_bound(times_.begin(), times_.end(), after) - times_.begin() };
+    const auto end{ std::upper_bound(times_.begin(), times_.end(), last) - times_.begin() };
+    if (end <= first)
+    {
+        return { 0, 0 };
+    }
+
+    const auto totalBefore{ (first == 0) ? int64_t{ 0 } : runningTotals_[first - 1] };
+    return { static_cast<std::size_t>(end - first), runningTotals_[end - 1] - totalBefore };
+}
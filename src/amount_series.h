@@ -0,0 +1,42 @@
+#ifndef PROCESS_OPERATIONS_AMOUNT_SERIES_H
+#define PROCESS_OPERATIONS_AMOUNT_SERIES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory_resource>
+#include <vector>
+
+namespace mybank
+{
+
+struct window_totals
+{
+    std::size_t count;
+    int64_t amount;
+};
+
+// Transaction times in order with the running total of their amounts, so the number and
+// total amount of the transactions in any time range take two binary searches
+class AmountSeries
+{
+public:
+    // Allocates from the memory resource of the allocator, passed on by the pmr containers holding series
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    explicit AmountSeries(const allocator_type & = {});
+
+    // Appended in the common in order case, later totals are updated for late transactions
+    void add(time_t timeInMillis, int64_t amount);
+
+    // Transactions with a time in (after, last]
+    auto totals(time_t after, time_t last) const -> mybank::window_totals;
+
+private:
+    std::pmr::vector<time_t> times_;
+    std::pmr::vector<int64_t> runningTotals_;
+};
+
+} // namespace mybank
+
+#endif // PROCESS_OPERATIONS_AMOUNT_SERIES_H
@@ -0,0 +1,255 @@
+#include <cstring>
+
+#include "decode_kernels.h"
+
+namespace
+{
+
+constexpr uint64_t zeroBytes{ 0x3030303030303030 };
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+constexpr bool swarAvailable{ true };
+#else
+constexpr bool swarAvailable{ false };
+#endif
+
+// Little endian load, the first character ends up in the lowest byte
+auto load_eight(const char *characters) -> uint64_t
+{
+    uint64_t word;
+    std::memcpy(&word, characters, sizeof(word));
+    return word;
+}
+
+auto is_eight_digits(uint64_t word) -> bool
+{
+    // Every byte must be 0x30..0x39: high nibble 3 and low nibble not overflowing past 9 when adding 6
+    return (((word & 0xF0F0F0F0F0F0F0F0) | (((word + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+            0x3333333333333333);
+}
+
+auto parse_eight_digits(uint64_t word) -> uint32_t
+{
+    word -= zeroBytes;
+    word = (word * 10) + (word >> 8);
+    word = (((word & 0x000000FF000000FF) * 0x000F424000000064) +
+            (((word >> 16) & 0x000000FF000000FF) * 0x0000271000000001)) >> 32;
+    return static_cast<uint32_t>(word);
+}
+
+// Loads the 8 bytes ending at end and replaces the count leading bytes not part of the number with '0'
+auto load_eight_ending_at(std::string_view line, std::size_t end, std::size_t count) -> uint64_t
+{
+    const auto word{ load_eight(line.data() + end - 8) };
+    const auto paddingMask{ (count == 8) ? 0 : (~uint64_t{ 0 } >> (count * 8)) };
+    return (word & ~paddingMask) | (zeroBytes & paddingMask);
+}
+
+auto two_digits(const char *characters) -> int
+{
+    return (characters[0] - '0')*10 + (characters[1] - '0');
+}
+
+// Same interpretation as strptime then mktime of the scalar path, standard time with tm_isdst 0
+auto local_time(int year, int month, int day, int hour, int minute, int second) -> time_t
+{
+    tm time{};
+    memset(&time, 0, sizeof(tm));
+    time.tm_year = year - 1900;
+    time.tm_mon = month - 1;
+    time.tm_mday = day;
+    time.tm_hour = hour;
+    time.tm_min = minute;
+    time.tm_sec = second;
+    return mktime(&time);
+}
+
+} // namespace
+
+auto mybank::count_digits(std::string_view line, std::size_t first) -> std::size_t
+{
+    auto position{ first };
+
+    if (swarAvailable)
+    {
+        for (; position + 8 <= line.size(); position += 8)
+        {
+            // Digits become 0x00..0x09, any other byte gets a bit set in its high nibble.
+            // Carries only move towards later characters, so the first flagged byte is exact.
+            const auto word{ load_eight(line.data() + position) ^ zeroBytes };
+            const auto nonDigits{ (word | (word + 0x0606060606060606)) & 0xF0F0F0F0F0F0F0F0 };
+
+            if (nonDigits != 0)
+            {
+                return position + static_cast<std::size_t>(__builtin_ctzll(nonDigits)) / 8 - first;
+            }
+        }
+    }
+
+    while (position < line.size() && line[position] >= '0' && line[position] <= '9')
+    {
+        ++position;
+    }
+
+    return position - first;
+}
+
+auto mybank::parse_digits_scalar(std::string_view line, std::size_t first, std::size_t last, int64_t &value) -> bool
+{
+    if (last <= first || last - first > maxParsedDigits || last > line.size())
+    {
+        return false;
+    }
+
+    int64_t parsed{ 0 };
+    for (auto i{ first }; i < last; ++i)
+    {
+        if (line[i] < '0' || line[i] > '9')
+        {
+            return false;
+        }
+        parsed = parsed*10 + (line[i] - '0');
+    }
+
+    value = parsed;
+    return true;
+}
+
+auto mybank::parse_digits(std::string_view line, std::size_t first, std::size_t last, int64_t &value) -> bool
+{
+    if (!swarAvailable || last <= first || last - first > maxParsedDigits || last > line.size())
+    {
+        return parse_digits_scalar(line, first, last, value);
+    }
+
+    // The masked load of a short leading group reads the 8 bytes ending past it, up to 7 before the number
+    const auto leading{ (last - first) % 8 };
+    if (leading != 0 && first + leading < 8)
+    {
+        return parse_digits_scalar(line, first, last, value);
+    }
+
+    int64_t parsed{ 0 };
+    auto position{ first };
+
+    if (leading != 0)
+    {
+        const auto word{ load_eight_ending_at(line, first + leading, leading) };
+        if (!is_eight_digits(word))
+        {
+            return false;
+        }
+
+        parsed = parse_eight_digits(word);
+        position += leading;
+    }
+
+    for (; position < last; position += 8)
+    {
+        const auto word{ load_eight(line.data() + position) };
+        if (!is_eight_digits(word))
+        {
+            return false;
+        }
+
+        parsed = parsed*100000000 + parse_eight_digits(word);
+    }
+
+    value = parsed;
+    return true;
+}
+
+auto mybank::iso8601_to_millis(std::string_view timeIso8601) -> time_t
+{
+    time_t timeInMillis;
+    if (iso8601_to_millis_fast(timeIso8601, timeInMillis))
+    {
+        return timeInMillis;
+    }
+
+    // Other layouts are rare enough for the copy strptime needs
+    return iso8601_to_millis_scalar(std::string{ timeIso8601 });
+}
+
+auto mybank::iso8601_to_millis_scalar(const std::string &timeIso8601) -> time_t
+{
+    tm time{};
+    memset(&time, 0, sizeof(tm));
+    strptime(timeIso8601.c_str(), "%Y-%m-%dT%H:%M:%SZ", &time);
+    const auto milliseconds{ (timeIso8601.length() > 20) ? std::strtol(&timeIso8601[20], nullptr, 10) : 0 };
+    return mktime(&time)*1000 + milliseconds;
+}
+
+auto mybank::iso8601_to_millis_fast(std::string_view timeIso8601, time_t &timeInMillis) -> bool
+{
+    // yyyy-mm-ddThh:mm:ss.sssZ
+    constexpr std::size_t length{ 24 };
+    // Digits replaced by '0', the masks select the digit bytes of each 8 characters
+    constexpr std::string_view layout{ "0000-00-00T00:00:00.000Z" };
+    constexpr uint64_t digitsMask[]{ 0x00FFFF00FFFFFFFF, 0xFFFF00FFFF00FFFF, 0x00FFFFFF00FFFF00 };
+
+    if (!swarAvailable || timeIso8601.size() != length)
+    {
+        return false;
+    }
+
+    for (std::size_t i{ 0 }; i < 3; ++i)
+    {
+        const auto word{ load_eight(timeIso8601.data() + 8*i) };
+        const auto expected{ load_eight(layout.data() + 8*i) };
+
+        // Separators must match exactly, digit positions must hold digits
+        if (((word ^ expected) & ~digitsMask[i]) != 0 ||
+            !is_eight_digits((word & digitsMask[i]) | (zeroBytes & ~digitsMask[i])))
+        {
+            return false;
+        }
+    }
+
+    const auto *characters{ timeIso8601.data() };
+    const auto year{ two_digits(characters)*100 + two_digits(characters + 2) };
+    const auto month{ two_digits(characters + 5) };
+    const auto day{ two_digits(characters + 8) };
+    const auto hour{ two_digits(characters + 11) };
+    const auto minute{ two_digits(characters + 14) };
+    const auto second{ two_digits(characters + 17) };
+    const auto millisecond{ two_digits(characters + 20)*10 + (characters[22] - '0') };
+
+    // Ranges strptime accepts without any special handling, the rest goes through it
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 59)
+    {
+        return false;
+    }
+
+    // mktime is only called once per day and thread. Days with a change of UTC offset are not linear
+    // from midnight, their times go through mktime each.
+    thread_local int cachedDay{ -1 };
+    thread_local time_t cachedMidnight{ 0 };
+    thread_local bool cachedLinear{ false };
+
+    const auto dayKey{ (year*100 + month)*100 + day };
+    if (dayKey != cachedDay)
+    {
+        cachedMidnight = local_time(year, month, day, 0, 0, 0);
+
+        // Next midnight normalized by mktime, also across month and year ends
+        const auto nextMidnight{ local_time(year, month, day + 1, 0, 0, 0) };
+        cachedLinear = cachedMidnight != -1 && nextMidnight != -1 && nextMidnight - cachedMidnight == 86400;
+        cachedDay = dayKey;
+    }
+
+    if (!cachedLinear)
+    {
+        const auto seconds{ local_time(year, month, day, hour, minute, second) };
+        if (seconds == -1)
+        {
+            return false;
+        }
+
+        timeInMillis = seconds*1000 + millisecond;
+        return true;
+    }
+
+    timeInMillis = (cachedMidnight + hour*3600 + minute*60 + second)*1000 + millisecond;
+    return true;
+}
\ No newline at end of file
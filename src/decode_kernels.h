@@ -0,0 +1,33 @@
+#ifndef PROCESS_OPERATIONS_DECODE_KERNELS_H
+#define PROCESS_OPERATIONS_DECODE_KERNELS_H
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+
+namespace mybank
+{
+
+// Longest digit sequence that always fits in an int64_t
+constexpr std::size_t maxParsedDigits{ 18 };
+
+// Number of consecutive ASCII digits starting at first, checking 8 bytes at a time
+auto count_digits(std::string_view line, std::size_t first) -> std::size_t;
+
+// Value of the ASCII digits in line[first, last), at most maxParsedDigits of them.
+// Converts 8 digits at a time with SWAR arithmetic, returns false if any byte is not a digit.
+auto parse_digits(std::string_view line, std::size_t first, std::size_t last, int64_t &) -> bool;
+auto parse_digits_scalar(std::string_view line, std::size_t first, std::size_t last, int64_t &) -> bool;
+
+// Milliseconds since the epoch of a yyyy-mm-ddThh:mm:ss.sssZ time, interpreted like
+// strptime + mktime always did (local time zone, seconds field parsed up to the 'Z')
+auto iso8601_to_millis(std::string_view) -> time_t;
+
+// Fixed width kernel, returns false for anything but a well formed 24 characters time
+auto iso8601_to_millis_fast(std::string_view, time_t &) -> bool;
+auto iso8601_to_millis_scalar(const std::string &) -> time_t;
+
+} // namespace mybank
+
+#endif // PROCESS_OPERATIONS_DECODE_KERNELS_H
@@ -0,0 +1,193 @@
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "process_operations/process_operations.h"
+#include "decode_kernels.h"
+#include "fast_decode.h"
+#include "json_utils.h"
+
+namespace
+{
+
+constexpr std::string_view accountPrefix{ R"({"account":{"activeAccount":)" };
+constexpr std::string_view availableLimitKey{ R"(,"availableLimit":)" };
+constexpr std::string_view accountSuffix{ R"(}})" };
+
+constexpr std::string_view transactionPrefix{ R"({"transaction":{"merchant":")" };
+constexpr std::string_view amountKey{ R"(","amount":)" };
+constexpr std::string_view timeKey{ R"(,"time":")" };
+constexpr std::string_view transactionSuffix{ R"("}})" };
+
+auto consume(std::string_view line, std::size_t &position, std::string_view literal) -> bool
+{
+    if (line.size() - position < literal.size() ||
+        std::memcmp(line.data() + position, literal.data(), literal.size()) != 0)
+    {
+        return false;
+    }
+
+    position += literal.size();
+    return true;
+}
+
+// Scalar equivalent of the SIMD scan for a single character
+auto is_string_special(char c) -> bool
+{
+    return c == '"' || c == '\\' || static_cast<signed char>(c) < 0x20;
+}
+
+// Returns the position of the closing quote of a string starting at position, or npos when the
+// string has escapes, control characters or non-ASCII bytes that only the general decoder handles
+auto find_plain_string_end(std::string_view line, std::size_t position) -> std::size_t
+{
+#if defined(__SSE2__)
+    const auto quote{ _mm_set1_epi8('"') };
+    const auto backslash{ _mm_set1_epi8('\\') };
+    // Signed comparison, bytes >= 0x80 are negative and so are also flagged
+    const auto firstPrintable{ _mm_set1_epi8(0x20) };
+
+    for (; position + 16 <= line.size(); position += 16)
+    {
+        const auto block{ _mm_loadu_si128(reinterpret_cast<const __m128i *>(line.data() + position)) };
+        const auto special{ _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash)),
+                _mm_cmplt_epi8(block, firstPrintable)) };
+
+        const auto mask{ static_cast<unsigned>(_mm_movemask_epi8(special)) };
+        if (mask != 0)
+        {
+            const auto end{ position + static_cast<std::size_t>(__builtin_ctz(mask)) };
+            return line[end] == '"' ? end : std::string_view::npos;
+        }
+    }
+#endif
+
+    for (; position < line.size(); ++position)
+    {
+        if (is_string_special(line[position]))
+        {
+            return line[position] == '"' ? position : std::string_view::npos;
+        }
+    }
+
+    return std::string_view::npos;
+}
+
+// JSON integer without fraction or exponent, small enough to never overflow
+auto consume_integer(std::string_view line, std::size_t &position, int64_t &value) -> bool
+{
+    const auto negative{ position < line.size() && line[position] == '-' };
+    const auto firstDigit{ negative ? position + 1 : position };
+
+    const auto digits{ mybank::count_digits(line, firstDigit) };
+    const auto end{ firstDigit + digits };
+    int64_t magnitude{ 0 };
+
+    if (digits == 0 || (digits > 1 && line[firstDigit] == '0') ||
+        !mybank::parse_digits(line, firstDigit, end, magnitude))
+    {
+        return false;
+    }
+
+    value = negative ? -magnitude : magnitude;
+    position = end;
+    return true;
+}
+
+auto consume_boolean(std::string_view line, std::size_t &position, bool &value) -> bool
+{
+    if (consume(line, position, "true"))
+    {
+        value = true;
+        return true;
+    }
+
+    if (consume(line, position, "false"))
+    {
+        value = false;
+        return true;
+    }
+
+    return false;
+}
+
+auto decode_account_fast(std::string_view line, mybank::account &account) -> bool
+{
+    std::size_t position{ 0 };
+
+    return consume(line, position, accountPrefix) &&
+           consume_boolean(line, position, account.activeAccount) &&
+           consume(line, position, availableLimitKey) &&
+           consume_integer(line, position, account.availableLimit) &&
+           consume(line, position, accountSuffix) &&
+           position == line.size();
+}
+
+auto decode_transaction_fast(std::string_view line, mybank::transaction_view &transaction) -> bool
+{
+    std::size_t position{ 0 };
+
+    if (!consume(line, position, transactionPrefix))
+    {
+        return false;
+    }
+
+    const auto merchantEnd{ find_plain_string_end(line, position) };
+    if (merchantEnd == std::string_view::npos)
+    {
+        return false;
+    }
+
+    const auto merchant{ line.substr(position, merchantEnd - position) };
+    position = merchantEnd;
+
+    if (!consume(line, position, amountKey) ||
+        !consume_integer(line, position, transaction.amount) ||
+        !consume(line, position, timeKey))
+    {
+        return false;
+    }
+
+    const auto timeEnd{ find_plain_string_end(line, position) };
+    if (timeEnd == std::string_view::npos)
+    {
+        return false;
+    }
+
+    const auto time{ line.substr(position, timeEnd - position) };
+    position = timeEnd;
+
+    if (!consume(line, position, transactionSuffix) || position != line.size())
+    {
+        return false;
+    }
+
+    transaction.merchant = merchant;
+    transaction.timeIso8601 = time;
+    transaction.timeInMillis = mybank::iso8601_to_millis(time);
+    return true;
+}
+
+} // namespace
+
+auto mybank::decode_operation_fast(std::string_view line, operation_view &operation) -> bool
+{
+    if (line.size() > 2 && line[2] == 't' && decode_transaction_fast(line, operation.transaction))
+    {
+        operation.type = mybank::OperationType::TRANSACTION;
+        return true;
+    }
+
+    if (line.size() > 2 && line[2] == 'a' && decode_account_fast(line, operation.account))
+    {
+        operation.type = mybank::OperationType::ACCOUNT;
+        return true;
+    }
+
+    return false;
+}
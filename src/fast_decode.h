@@ -0,0 +1,21 @@
+#ifndef PROCESS_OPERATIONS_FAST_DECODE_H
+#define PROCESS_OPERATIONS_FAST_DECODE_H
+
+#include <string_view>
+
+namespace mybank
+{
+
+struct operation_view;
+
+// Decodes lines with exactly the shape our producer emits, without whitespace and with the keys in order:
+// {"account":{"activeAccount":bool,"availableLimit":int}}
+// {"transaction":{"merchant":string,"amount":int,"time":string}}
+// Returns false for anything else (including escaped or non-ASCII strings), which must then go
+// through the general JSON decoder, so both always agree on the lines accepted here.
+// The strings of a decoded transaction point into the line.
+auto decode_operation_fast(std::string_view, operation_view &) -> bool;
+
+} // namespace mybank
+
+#endif // PROCESS_OPERATIONS_FAST_DECODE_H
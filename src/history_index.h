@@ -0,0 +1,103 @@
+#ifndef PROCESS_OPERATIONS_HISTORY_INDEX_H
+#define PROCESS_OPERATIONS_HISTORY_INDEX_H
+
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <functional>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "process_operations/process_operations.h"
+#include "amount_series.h"
+#include "spend_window.h"
+#include "time_buckets.h"
+
+namespace mybank
+{
+
+// Rule options with the values derived from them, computed once per authorizer
+struct compiled_rules
+{
+    time_t smallIntervalMillis;
+    std::size_t frequencyLimit;
+    std::size_t equalLimit;
+
+    // Resolution of the frequency buckets, so a window spans the same number of them whatever its length
+    time_t frequencyBucketMillis;
+    std::size_t frequencyBucketCount;
+
+    std::vector<mybank::velocity_rule> velocityRules;
+
+    time_t spendWindowMillis;
+    int64_t maxSpendInWindow;
+};
+
+auto compile_rules(const mybank::rule_options &) -> mybank::compiled_rules;
+
+struct merchant_amount
+{
+    uint32_t merchantId;
+    int64_t amount;
+
+    auto operator==(const merchant_amount &other) const -> bool
+    {
+        return merchantId == other.merchantId && amount == other.amount;
+    }
+};
+
+struct merchant_amount_hash
+{
+    auto operator()(const merchant_amount &key) const -> std::size_t
+    {
+        return std::hash<int64_t>{}(key.amount*31 + key.merchantId);
+    }
+};
+
+// Matching valid transactions of a velocity rule, all together or by merchant id
+struct velocity_index
+{
+    mybank::AmountSeries transactions;
+    std::pmr::unordered_map<uint32_t, mybank::AmountSeries> merchantTransactions;
+};
+
+// Counts kept up to date as transactions are admitted into the valid transactions history,
+// so the validations do not depend on how many transactions the window holds.
+// Containers growing with the history allocate from the memory resource given to make_history_index.
+struct history_index
+{
+    mybank::compiled_rules rules;
+
+    // Covering twice the interval, the span of transactions a new one is checked against
+    mybank::TimeBuckets frequencyBuckets;
+
+    // Merchants numbered in order of their first valid transaction, the names interned once
+    // so transactions are looked up by the views they were decoded into
+    std::pmr::deque<std::pmr::string> merchantNames;
+    std::pmr::unordered_map<std::string_view, uint32_t> merchantIds;
+
+    // Sorted times of the valid transactions of each merchant and amount
+    std::pmr::unordered_map<mybank::merchant_amount, std::pmr::vector<time_t>, mybank::merchant_amount_hash> equalTransactionTimes;
+
+    // One for each velocity rule, in the same order
+    std::vector<mybank::velocity_index> velocity{};
+
+    mybank::SpendWindow spendWindow;
+};
+
+struct transaction_view;
+
+void add_to_history_index(mybank::history_index &, const mybank::transaction_view &);
+
+auto make_history_index(
+        const mybank::rule_options &,
+        const mybank::transaction_history &,
+        std::pmr::memory_resource * = std::pmr::get_default_resource())
+        -> mybank::history_index;
+
+} // namespace mybank
+
+#endif // PROCESS_OPERATIONS_HISTORY_INDEX_H
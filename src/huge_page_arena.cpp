@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include "huge_page_arena.h"
+
+namespace
+{
+
+// Allocations from this size on get regions of their own, and are larger than any block of the arena's pools
+constexpr std::size_t ownRegionBytes{ mybank::hugePageSize/2 };
+
+auto round_up(std::size_t value, std::size_t multiple) -> std::size_t
+{
+    return (value + multiple - 1)/multiple*multiple;
+}
+
+auto bytes_backed_by(mybank::huge_page_usage &usage, mybank::HugePages backing) -> std::size_t &
+{
+    switch (backing)
+    {
+        case mybank::HugePages::HUGETLBFS:
+            return usage.hugetlbfsBytes;
+        case mybank::HugePages::TRANSPARENT:
+            return usage.transparentBytes;
+        default:
+            return usage.normalBytes;
+    }
+}
+
+} // namespace
+
+mybank::HugePageResource::HugePageResource(mybank::HugePages mode)
+        : mode_{ mode }
+{
+}
+
+mybank::HugePageResource::~HugePageResource()
+{
+    for (const auto &region : sharedRegions_)
+    {
+        unmap(region);
+    }
+
+    for (const auto &region : ownRegions_)
+    {
+        unmap(region);
+    }
+}
+
+auto mybank::HugePageResource::usage() const -> mybank::huge_page_usage
+{
+    return usage_;
+}
+
+auto mybank::HugePageResource::do_allocate(std::size_t bytes, std::size_t alignment) -> void *
+{
+    if (bytes >= ownRegionBytes)
+    {
+        const auto own{ map(round_up(bytes, hugePageSize)) };
+        if (own.address == nullptr)
+        {
+            // Out of memory, failing like any other allocation would
+            return std::pmr::null_memory_resource()->allocate(bytes, alignment);
+        }
+
+        ownRegions_.push_back(own);
+        bytes_backed_by(usage_, own.backing) += own.size;
+        return own.address;
+    }
+
+    auto offset{ round_up(sharedUsed_, alignment) };
+    if (sharedRegions_.empty() || offset + bytes > hugePageSize)
+    {
+        const auto shared{ map(hugePageSize) };
+        if (shared.address == nullptr)
+        {
+            return std::pmr::null_memory_resource()->allocate(bytes, alignment);
+        }
+
+        sharedRegions_.push_back(shared);
+        bytes_backed_by(usage_, shared.backing) += shared.size;
+        offset = 0;
+    }
+
+    sharedUsed_ = offset + bytes;
+    return static_cast<char *>(sharedRegions_.back().address) + offset;
+}
+
+void mybank::HugePageResource::do_deallocate(void *address, std::size_t bytes, std::size_t)
+{
+    if (bytes < ownRegionBytes)
+    {
+        return;
+    }
+
+    const auto own{ std::find_if(ownRegions_.begin(), ownRegions_.end(), [address](const region &region) {
+        return region.address == address;
+    }) };
+    if (own == ownRegions_.end())
+    {
+        return;
+    }
+
+    bytes_backed_by(usage_, own->backing) -= own->size;
+    unmap(*own);
+    *own = ownRegions_.back();
+    ownRegions_.pop_back();
+}
+
+auto mybank::HugePageResource::do_is_equal(const std::pmr::memory_resource &other) const noexcept -> bool
+{
+    return this == &other;
+}
+
+auto mybank::HugePageResource::map(std::size_t size) -> region
+{
+#ifdef __linux__
+    if (mode_ == mybank::HugePages::HUGETLBFS)
+    {
+        auto flags{ MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB };
+#ifdef MAP_HUGE_SHIFT
+        flags |= 21 << MAP_HUGE_SHIFT;
+#endif
+        auto *address{ ::mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0) };
+        if (address != MAP_FAILED)
+        {
+            return { address, size, mybank::HugePages::HUGETLBFS };
+        }
+    }
+
+    // Mapped a huge page larger, so an aligned region the kernel can back with huge pages is cut out of it
+    auto *mapped{ ::mmap(nullptr, size + hugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) };
+    if (mapped == MAP_FAILED)
+    {
+        return { nullptr, 0, mybank::HugePages::OFF };
+    }
+
+    auto *start{ static_cast<char *>(mapped) };
+    auto *aligned{ start + (hugePageSize - reinterpret_cast<uintptr_t>(start)%hugePageSize)%hugePageSize };
+    if (aligned != start)
+    {
+        ::munmap(start, static_cast<std::size_t>(aligned - start));
+    }
+
+    const auto tail{ static_cast<std::size_t>(start + hugePageSize - aligned) };
+    if (tail > 0)
+    {
+        ::munmap(aligned + size, tail);
+    }
+
+    const auto advised{ mode_ != mybank::HugePages::OFF && ::madvise(aligned, size, MADV_HUGEPAGE) == 0 };
+    return { aligned, size, advised ? mybank::HugePages::TRANSPARENT : mybank::HugePages::OFF };
+#else
+    return { ::operator new(size, std::align_val_t{ hugePageSize }, std::nothrow), size, mybank::HugePages::OFF };
+#endif
+}
+
+void mybank::HugePageResource::unmap(const region &region)
+{
+#ifdef __linux__
+    ::munmap(region.address, region.size);
+#else
+    ::operator delete(region.address, std::align_val_t{ hugePageSize });
+#endif
+}
+
+mybank::HugePageArena::HugePageArena(mybank::HugePages mode)
+        : pages_{ mode },
+          pool_{ std::pmr::pool_options{ 0, ownRegionBytes - 1 }, &pages_ }
+{
+}
+
+auto mybank::HugePageArena::resource() -> std::pmr::memory_resource *
+{
+    return &pool_;
+}
+
+auto mybank::HugePageArena::usage() const -> mybank::huge_page_usage
+{
+    return pages_.usage();
+}
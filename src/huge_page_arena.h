@@ -0,0 +1,79 @@
+#ifndef PROCESS_OPERATIONS_HUGE_PAGE_ARENA_H
+#define PROCESS_OPERATIONS_HUGE_PAGE_ARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+#include "process_operations/process_operations.h"
+
+namespace mybank
+{
+
+constexpr std::size_t hugePageSize{ 2*1024*1024 };
+
+// Bytes currently mapped by a HugePageResource, by the pages backing them
+struct huge_page_usage
+{
+    std::size_t hugetlbfsBytes;
+    // madvise(MADV_HUGEPAGE) accepted, the kernel may still use normal pages for some of them
+    std::size_t transparentBytes;
+    std::size_t normalBytes;
+};
+
+// Memory resource mapping 2 MB aligned regions, backed by the huge pages the mode asks for when
+// the system provides them and by normal pages otherwise.
+// Allocations of at least half a huge page get regions of their own, unmapped when deallocated.
+// Smaller ones are carved out of shared regions only unmapped with the resource, so it is meant
+// to be the upstream of a pool resource.
+class HugePageResource : public std::pmr::memory_resource
+{
+public:
+    explicit HugePageResource(mybank::HugePages);
+    HugePageResource(const HugePageResource &) = delete;
+    HugePageResource &operator=(const HugePageResource &) = delete;
+    ~HugePageResource() override;
+
+    auto usage() const -> mybank::huge_page_usage;
+
+private:
+    struct region
+    {
+        void *address;
+        std::size_t size;
+        mybank::HugePages backing;
+    };
+
+    auto do_allocate(std::size_t bytes, std::size_t alignment) -> void * override;
+    void do_deallocate(void *, std::size_t bytes, std::size_t alignment) override;
+    auto do_is_equal(const std::pmr::memory_resource &) const noexcept -> bool override;
+
+    // Region of a multiple of hugePageSize with the best backing available, nullptr address when out of memory
+    auto map(std::size_t size) -> region;
+    void unmap(const region &);
+
+    mybank::HugePages mode_;
+    std::vector<region> sharedRegions_{};
+    std::size_t sharedUsed_{ 0 };
+    std::vector<region> ownRegions_{};
+    mybank::huge_page_usage usage_{};
+};
+
+// Pool of the history and index allocations of an Authorizer, in the regions of a HugePageResource.
+// Not thread safe, like the history it holds.
+class HugePageArena
+{
+public:
+    explicit HugePageArena(mybank::HugePages);
+
+    auto resource() -> std::pmr::memory_resource *;
+    auto usage() const -> mybank::huge_page_usage;
+
+private:
+    mybank::HugePageResource pages_;
+    std::pmr::unsynchronized_pool_resource pool_;
+};
+
+} // namespace mybank
+
+#endif // PROCESS_OPERATIONS_HUGE_PAGE_ARENA_H
@@ -0,0 +1,252 @@
+#include <cerrno>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "io_uring.h"
+
+namespace
+{
+
+auto io_uring_setup(unsigned entries, io_uring_params &params) -> int
+{
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+}
+
+auto io_uring_enter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) -> int
+{
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+auto io_uring_register(int fd, unsigned opcode, const void *arguments, unsigned count) -> int
+{
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arguments, count));
+}
+
+template<typename T>
+auto at_offset(void *base, unsigned offset) -> T *
+{
+    return reinterpret_cast<T *>(static_cast<char *>(base) + offset);
+}
+
+} // namespace
+
+auto mybank::IoUring::create(unsigned entries) -> std::optional<IoUring>
+{
+    io_uring_params params{};
+    std::memset(&params, 0, sizeof(params));
+
+    IoUring ring{};
+    ring.fd_ = io_uring_setup(entries, params);
+    if (ring.fd_ < 0)
+    {
+        return std::nullopt;
+    }
+
+    ring.ringSize_ = params.sq_off.array + params.sq_entries*sizeof(unsigned);
+    ring.completionSize_ = params.cq_off.cqes + params.cq_entries*sizeof(io_uring_cqe);
+
+    const auto singleMmap{ (params.features & IORING_FEAT_SINGLE_MMAP) != 0 };
+    if (singleMmap && ring.completionSize_ > ring.ringSize_)
+    {
+        ring.ringSize_ = ring.completionSize_;
+    }
+
+    ring.ringMemory_ = ::mmap(nullptr, ring.ringSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                              ring.fd_, IORING_OFF_SQ_RING);
+    if (ring.ringMemory_ == MAP_FAILED)
+    {
+        ring.ringMemory_ = nullptr;
+        return std::nullopt;
+    }
+
+    if (singleMmap)
+    {
+        ring.completionMemory_ = ring.ringMemory_;
+        ring.completionSize_ = 0;
+    }
+    else
+    {
+        ring.completionMemory_ = ::mmap(nullptr, ring.completionSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                        ring.fd_, IORING_OFF_CQ_RING);
+        if (ring.completionMemory_ == MAP_FAILED)
+        {
+            ring.completionMemory_ = nullptr;
+            return std::nullopt;
+        }
+    }
+
+    ring.sqesSize_ = params.sq_entries*sizeof(io_uring_sqe);
+    auto *sqes{ ::mmap(nullptr, ring.sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ring.fd_, IORING_OFF_SQES) };
+    if (sqes == MAP_FAILED)
+    {
+        return std::nullopt;
+    }
+    ring.sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+    ring.sqHead_ = at_offset<unsigned>(ring.ringMemory_, params.sq_off.head);
+    ring.sqTail_ = at_offset<unsigned>(ring.ringMemory_, params.sq_off.tail);
+    ring.sqArray_ = at_offset<unsigned>(ring.ringMemory_, params.sq_off.array);
+    ring.sqMask_ = *at_offset<unsigned>(ring.ringMemory_, params.sq_off.ring_mask);
+    ring.sqEntries_ = params.sq_entries;
+    ring.sqLocalTail_ = *ring.sqTail_;
+    ring.sqSubmittedTail_ = ring.sqLocalTail_;
+
+    ring.cqHead_ = at_offset<unsigned>(ring.completionMemory_, params.cq_off.head);
+    ring.cqTail_ = at_offset<unsigned>(ring.completionMemory_, params.cq_off.tail);
+    ring.cqes_ = at_offset<io_uring_cqe>(ring.completionMemory_, params.cq_off.cqes);
+    ring.cqMask_ = *at_offset<unsigned>(ring.completionMemory_, params.cq_off.ring_mask);
+
+    ring.probe();
+
+    return std::optional<IoUring>{ std::move(ring) };
+}
+
+mybank::IoUring::IoUring(IoUring &&other) noexcept
+        : fd_{ std::exchange(other.fd_, -1) },
+          supported_{ other.supported_ },
+          ringMemory_{ std::exchange(other.ringMemory_, nullptr) },
+          ringSize_{ other.ringSize_ },
+          completionMemory_{ std::exchange(other.completionMemory_, nullptr) },
+          completionSize_{ other.completionSize_ },
+          sqes_{ std::exchange(other.sqes_, nullptr) },
+          sqesSize_{ other.sqesSize_ },
+          sqHead_{ other.sqHead_ },
+          sqTail_{ other.sqTail_ },
+          sqArray_{ other.sqArray_ },
+          sqMask_{ other.sqMask_ },
+          sqEntries_{ other.sqEntries_ },
+          sqLocalTail_{ other.sqLocalTail_ },
+          sqSubmittedTail_{ other.sqSubmittedTail_ },
+          cqHead_{ other.cqHead_ },
+          cqTail_{ other.cqTail_ },
+          cqes_{ other.cqes_ },
+          cqMask_{ other.cqMask_ }
+{
+}
+
+mybank::IoUring::~IoUring()
+{
+    if (sqes_ != nullptr)
+    {
+        ::munmap(sqes_, sqesSize_);
+    }
+
+    if (completionMemory_ != nullptr && completionMemory_ != ringMemory_)
+    {
+        ::munmap(completionMemory_, completionSize_);
+    }
+
+    if (ringMemory_ != nullptr)
+    {
+        ::munmap(ringMemory_, ringSize_);
+    }
+
+    if (fd_ >= 0)
+    {
+        ::close(fd_);
+    }
+}
+
+auto mybank::IoUring::register_buffers(const iovec *buffers, unsigned count) -> bool
+{
+    return io_uring_register(fd_, IORING_REGISTER_BUFFERS, buffers, count) == 0;
+}
+
+auto mybank::IoUring::supports(uint8_t opcode) const -> bool
+{
+    return supported_.test(opcode);
+}
+
+void mybank::IoUring::probe()
+{
+    // The header followed by an entry for every opcode a byte can hold
+    constexpr unsigned maxOperations{ 256 };
+    std::vector<uint64_t> storage((sizeof(io_uring_probe) + maxOperations*sizeof(io_uring_probe_op) + 7) / 8);
+    auto *probe{ reinterpret_cast<io_uring_probe *>(storage.data()) };
+
+    if (io_uring_register(fd_, IORING_REGISTER_PROBE, probe, maxOperations) != 0)
+    {
+        return;
+    }
+
+    for (unsigned i{ 0 }; i < probe->ops_len && i < maxOperations; ++i)
+    {
+        if ((probe->ops[i].flags & IO_URING_OP_SUPPORTED) != 0)
+        {
+            supported_.set(probe->ops[i].op);
+        }
+    }
+}
+
+auto mybank::IoUring::get_sqe() -> io_uring_sqe *
+{
+    const auto head{ __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE) };
+    if (sqLocalTail_ - head >= sqEntries_)
+    {
+        return nullptr;
+    }
+
+    const auto index{ sqLocalTail_ & sqMask_ };
+    auto *sqe{ &sqes_[index] };
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqArray_[index] = index;
+    ++sqLocalTail_;
+
+    return sqe;
+}
+
+auto mybank::IoUring::submit() -> bool
+{
+    const auto toSubmit{ sqLocalTail_ - sqSubmittedTail_ };
+    if (toSubmit == 0)
+    {
+        return true;
+    }
+
+    __atomic_store_n(sqTail_, sqLocalTail_, __ATOMIC_RELEASE);
+
+    for (;;)
+    {
+        const auto submitted{ io_uring_enter(fd_, toSubmit, 0, 0) };
+        if (submitted >= 0)
+        {
+            sqSubmittedTail_ = sqLocalTail_;
+            return true;
+        }
+
+        if (errno != EINTR)
+        {
+            return false;
+        }
+    }
+}
+
+auto mybank::IoUring::next_cqe(io_uring_cqe &cqe, bool wait) -> bool
+{
+    for (;;)
+    {
+        const auto head{ *cqHead_ };
+        if (head != __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE))
+        {
+            cqe = cqes_[head & cqMask_];
+            __atomic_store_n(cqHead_, head + 1, __ATOMIC_RELEASE);
+            return true;
+        }
+
+        if (!wait)
+        {
+            return false;
+        }
+
+        if (io_uring_enter(fd_, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+        {
+            return false;
+        }
+    }
+}
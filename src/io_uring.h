@@ -0,0 +1,74 @@
+#ifndef PROCESS_OPERATIONS_IO_URING_H
+#define PROCESS_OPERATIONS_IO_URING_H
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+
+namespace mybank
+{
+
+// Minimal io_uring over the raw system calls, without depending on liburing
+class IoUring
+{
+public:
+    // Returns std::nullopt when the kernel (or a seccomp filter) does not allow io_uring
+    static auto create(unsigned entries) -> std::optional<IoUring>;
+
+    IoUring(IoUring &&) noexcept;
+    IoUring &operator=(IoUring &&) = delete;
+    IoUring(const IoUring &) = delete;
+    IoUring &operator=(const IoUring &) = delete;
+    ~IoUring();
+
+    auto register_buffers(const iovec *, unsigned count) -> bool;
+
+    // Whether the kernel supports the operation, probed when the ring is created.
+    // None are reported by kernels without IORING_REGISTER_PROBE (before 5.6, also lacking IORING_OP_READ).
+    auto supports(uint8_t opcode) const -> bool;
+
+    // Zeroed entry to fill in, nullptr when the submission queue is full
+    auto get_sqe() -> io_uring_sqe *;
+
+    // Submits every entry obtained since the last call
+    auto submit() -> bool;
+
+    // Copies the next completion, waiting for one when asked to
+    auto next_cqe(io_uring_cqe &, bool wait) -> bool;
+
+private:
+    IoUring() = default;
+
+    void probe();
+
+    int fd_{ -1 };
+    std::bitset<256> supported_{};
+
+    void *ringMemory_{ nullptr };
+    std::size_t ringSize_{ 0 };
+    void *completionMemory_{ nullptr };
+    std::size_t completionSize_{ 0 };
+    io_uring_sqe *sqes_{ nullptr };
+    std::size_t sqesSize_{ 0 };
+
+    unsigned *sqHead_{ nullptr };
+    unsigned *sqTail_{ nullptr };
+    unsigned *sqArray_{ nullptr };
+    unsigned sqMask_{ 0 };
+    unsigned sqEntries_{ 0 };
+    unsigned sqLocalTail_{ 0 };
+    unsigned sqSubmittedTail_{ 0 };
+
+    unsigned *cqHead_{ nullptr };
+    unsigned *cqTail_{ nullptr };
+    io_uring_cqe *cqes_{ nullptr };
+    unsigned cqMask_{ 0 };
+};
+
+} // namespace mybank
+
+#endif // PROCESS_OPERATIONS_IO_URING_H
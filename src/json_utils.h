@@ -2,6 +2,9 @@
 #define PROCESS_OPERATIONS_JSON_UTILS_H
 
 #include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
 
 #include <nlohmann/json.hpp>
 
@@ -15,19 +18,76 @@ NLOHMANN_JSON_SERIALIZE_ENUM(Violation, {
     { Violation::ACCOUNT_NOT_ACTIVE, "account-not-active" },
     { Violation::DOUBLED_TRANSACTION, "doubled-transaction" },
     { Violation::HIGH_FREQUENCY_SMALL_INTERVAL, "high-frequency-small-interval" },
-    { Violation::INSUFFICIENT_LIMIT, "insufficient-limit" }
+    { Violation::INSUFFICIENT_LIMIT, "insufficient-limit" },
+    { Violation::SPEND_VELOCITY, "spend-velocity" },
+    { Violation::VELOCITY_AMOUNT_LIMIT, "velocity-amount-limit" },
+    { Violation::VELOCITY_COUNT_LIMIT, "velocity-count-limit" }
 })
 
+enum class OperationType
+{
+    ACCOUNT,
+    TRANSACTION,
+    UNKNOWN
+};
+
+// Transaction with its strings pointing into the input line, or into the decoder for lines that needed
+// the JSON parser. Validated as is, copied into a mybank::transaction only when admitted into the history.
+struct transaction_view
+{
+    int64_t amount;
+    std::string_view merchant;
+    std::string_view timeIso8601;
+    time_t timeInMillis;
+};
+
+auto to_view(const mybank::transaction &) -> mybank::transaction_view;
+auto to_transaction(const mybank::transaction_view &) -> mybank::transaction;
+
+// Input line decoded without copying it, only the member matching the type is set
+struct operation_view
+{
+    OperationType type;
+    mybank::account account;
+    mybank::transaction_view transaction;
+};
+
+// Input line already parsed and converted, owning its strings to outlive the line (e.g. in a queue),
+// only the member matching the type is set
+struct decoded_operation
+{
+    OperationType type;
+    mybank::account account;
+    mybank::transaction transaction;
+
+    auto view() const -> mybank::operation_view;
+};
+
+// Decodes lines into views that are valid while the line is and until the next call
+class OperationDecoder
+{
+public:
+    // nullptr for lines that are not valid JSON, which are ignored. Never throws.
+    auto decode(std::string_view) -> const mybank::operation_view *;
+
+private:
+    mybank::operation_view operation_{};
+
+    // Unescaped strings of the last line that went through the JSON parser
+    std::string merchant_{};
+    std::string timeIso8601_{};
+};
+
+// from_json expects json already checked by is_valid_json_account or is_valid_json_transaction,
+// so it never throws
 void to_json(json &, const account &);
 void from_json(const json &, account &);
 
 void to_json(json &, const transaction &);
 void from_json(const json &, transaction &);
 
-auto build_output_json(
-        const mybank::account &account,
-        const std::vector<mybank::Violation> &violations)
-        -> json;
+// Returns std::nullopt for lines that are not valid JSON, which are ignored. Never throws.
+auto decode_operation(std::string_view) -> std::optional<mybank::decoded_operation>;
 
 auto is_valid_json_account(const json &) -> bool;
 auto is_valid_json_transaction(const json &) -> bool;
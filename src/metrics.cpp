@@ -0,0 +1,112 @@
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include "process_operations/metrics.h"
+#include "json_utils.h"
+
+namespace
+{
+
+struct metric_description
+{
+    const char *name;
+    const char *type;
+    const char *help;
+};
+
+// Indexed by Metric
+constexpr metric_description metricDescriptions[]{
+    { "mybank_operations_total", "counter", "Input lines decoded as JSON" },
+    { "mybank_invalid_lines_total", "counter", "Input lines skipped for not being valid JSON" },
+    { "mybank_unknown_operations_total", "counter", "Decoded lines that are neither an account nor a transaction" },
+    { "mybank_accepted_transactions_total", "counter", "Transactions authorized without violations" },
+    { "mybank_history_transactions", "gauge", "Valid transactions kept in the history" },
+    { "mybank_spend_window_transactions", "gauge", "Valid transactions in the spend window" },
+    { "mybank_spend_window_evictions_total", "counter", "Transactions expired from the spend window" },
+    { "mybank_unpinned_threads_total", "counter", "Threads left unpinned because the system refused their CPUs" }
+};
+
+static_assert(std::size(metricDescriptions) == mybank::metricCount);
+static_assert(static_cast<std::size_t>(mybank::Violation::VELOCITY_COUNT_LIMIT) + 1 == mybank::violationCount);
+
+// Threads take shards in the order they first add to any Metrics
+std::atomic<std::size_t> nextThreadShard{ 0 };
+
+} // namespace
+
+auto mybank::Metrics::thread_shard() -> shard &
+{
+    thread_local const auto threadShard{ nextThreadShard.fetch_add(1, std::memory_order_relaxed) % shardCount };
+    return shards_[threadShard];
+}
+
+void mybank::Metrics::add(Metric metric, int64_t count)
+{
+    thread_shard().counters[static_cast<std::size_t>(metric)].fetch_add(count, std::memory_order_relaxed);
+}
+
+void mybank::Metrics::add(Violation violation)
+{
+    thread_shard().counters[metricCount + static_cast<std::size_t>(violation)].fetch_add(1, std::memory_order_relaxed);
+}
+
+auto mybank::Metrics::snapshot() const -> mybank::metrics_snapshot
+{
+    metrics_snapshot snapshot{};
+
+    for (const auto &shard : shards_)
+    {
+        for (std::size_t i{ 0 }; i < metricCount; ++i)
+        {
+            snapshot.metrics[i] += shard.counters[i].load(std::memory_order_relaxed);
+        }
+
+        for (std::size_t i{ 0 }; i < violationCount; ++i)
+        {
+            snapshot.violations[i] += shard.counters[metricCount + i].load(std::memory_order_relaxed);
+        }
+    }
+
+    return snapshot;
+}
+
+auto mybank::to_prometheus(const mybank::metrics_snapshot &snapshot) -> std::string
+{
+    std::ostringstream text;
+
+    for (std::size_t i{ 0 }; i < metricCount; ++i)
+    {
+        const auto &description{ metricDescriptions[i] };
+        text << "# HELP " << description.name << ' ' << description.help << '\n'
+             << "# TYPE " << description.name << ' ' << description.type << '\n'
+             << description.name << ' ' << snapshot.metrics[i] << '\n';
+    }
+
+    text << "# HELP mybank_violations_total Violations reported, by violation\n"
+         << "# TYPE mybank_violations_total counter\n";
+    for (std::size_t i{ 0 }; i < violationCount; ++i)
+    {
+        const json violationJson = static_cast<mybank::Violation>(i);
+        text << "mybank_violations_total{violation=\"" << violationJson.get<std::string>() << "\"} "
+             << snapshot.violations[i] << '\n';
+    }
+
+    return text.str();
+}
+
+auto mybank::write_prometheus(const mybank::Metrics &metrics, const std::string &path) -> bool
+{
+    const auto temporaryPath{ path + ".tmp" };
+    {
+        std::ofstream file{ temporaryPath, std::ios::trunc };
+        file << to_prometheus(metrics.snapshot());
+        if (!file.flush())
+        {
+            return false;
+        }
+    }
+
+    return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+}
@@ -0,0 +1,46 @@
+#ifndef PROCESS_OPERATIONS_NUMA_PLACEMENT_H
+#define PROCESS_OPERATIONS_NUMA_PLACEMENT_H
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "process_operations/numa_topology.h"
+
+namespace mybank
+{
+
+// Nodes the threads of the parallel decode mode run on
+struct numa_placement
+{
+    // Where the account and history were allocated, so the committer updating them stays local
+    std::size_t committerNode;
+    std::vector<std::size_t> decoderNodes;
+    // CPUs of the committer's node reserved with the committer's for the thread reading the input
+    std::vector<int> readerCpus;
+};
+
+// Decoders take the CPUs of the committer's node left after the committer and the reading thread,
+// then those of the other nodes in order, and past the CPUs of the machine go round robin over the nodes
+auto plan_numa_placement(
+        const mybank::numa_topology &,
+        std::size_t committerNode,
+        std::size_t decodeThreads)
+        -> mybank::numa_placement;
+
+// Node of the CPU the calling thread runs on, 0 when it is in none of the nodes
+auto current_numa_node(const mybank::numa_topology &) -> std::size_t;
+
+// Node of the memory backing the address, std::nullopt when the system cannot tell
+// (simulated topologies, no NUMA support, other systems than Linux)
+auto memory_numa_node(const mybank::numa_topology &, const void *address) -> std::optional<std::size_t>;
+
+// CPUs the calling thread may run on, empty when they cannot be read
+auto current_thread_cpus() -> std::vector<int>;
+
+// Restricts the calling thread to the CPUs, false when the system refuses them (e.g. a simulated topology)
+auto pin_current_thread(const std::vector<int> &cpus) -> bool;
+
+} // namespace mybank
+
+#endif // PROCESS_OPERATIONS_NUMA_PLACEMENT_H
@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "process_operations/numa_topology.h"
+#include "numa_placement.h"
+
+namespace
+{
+
+auto read_sysfs(const std::string &path) -> std::optional<std::vector<int>>
+{
+    std::ifstream file{ path };
+    if (!file)
+    {
+        return std::nullopt;
+    }
+
+    const std::string contents{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+    return mybank::parse_cpu_list(contents);
+}
+
+auto parse_number(std::string_view &list, int &number) -> bool
+{
+    const auto result{ std::from_chars(list.data(), list.data() + list.size(), number) };
+    if (result.ec != std::errc{} || number < 0)
+    {
+        return false;
+    }
+
+    list.remove_prefix(static_cast<std::size_t>(result.ptr - list.data()));
+    return true;
+}
+
+} // namespace
+
+auto mybank::parse_cpu_list(std::string_view list) -> std::optional<std::vector<int>>
+{
+    while (!list.empty() && (list.back() == '\n' || list.back() == ' '))
+    {
+        list.remove_suffix(1);
+    }
+
+    std::vector<int> cpus{};
+    while (!list.empty())
+    {
+        int first;
+        if (!parse_number(list, first))
+        {
+            return std::nullopt;
+        }
+
+        auto last{ first };
+        if (!list.empty() && list.front() == '-')
+        {
+            list.remove_prefix(1);
+            if (!parse_number(list, last) || last < first)
+            {
+                return std::nullopt;
+            }
+        }
+
+        for (auto cpu{ first }; cpu <= last; ++cpu)
+        {
+            cpus.push_back(cpu);
+        }
+
+        if (!list.empty())
+        {
+            if (list.front() != ',' || list.size() == 1)
+            {
+                return std::nullopt;
+            }
+            list.remove_prefix(1);
+        }
+    }
+
+    return cpus;
+}
+
+auto mybank::detect_numa_topology() -> mybank::numa_topology
+{
+    mybank::numa_topology topology{};
+
+    const std::string nodeDirectory{ "/sys/devices/system/node/" };
+    const auto nodes{ read_sysfs(nodeDirectory + "online") };
+    if (nodes.has_value())
+    {
+        for (const auto node : nodes.value())
+        {
+            // Nodes with memory only have no CPUs to run on
+            auto cpus{ read_sysfs(nodeDirectory + "node" + std::to_string(node) + "/cpulist") };
+            if (cpus.has_value() && !cpus->empty())
+            {
+                topology.nodeCpus.push_back(std::move(cpus.value()));
+                topology.nodeIds.push_back(node);
+            }
+        }
+    }
+
+    if (topology.nodeCpus.empty())
+    {
+        topology.nodeIds.clear();
+
+        std::vector<int> cpus(std::max(std::thread::hardware_concurrency(), 1u));
+        for (std::size_t cpu{ 0 }; cpu < cpus.size(); ++cpu)
+        {
+            cpus[cpu] = static_cast<int>(cpu);
+        }
+        topology.nodeCpus.push_back(std::move(cpus));
+    }
+
+    return topology;
+}
+
+auto mybank::plan_numa_placement(
+        const mybank::numa_topology &topology,
+        std::size_t committerNode,
+        std::size_t decodeThreads)
+        -> mybank::numa_placement
+{
+    const auto nodeCount{ std::max<std::size_t>(topology.nodeCpus.size(), 1) };
+    committerNode = std::min(committerNode, nodeCount - 1);
+
+    // The committer's node first, then the others in order
+    std::vector<std::size_t> nodes{ committerNode };
+    for (std::size_t node{ 0 }; node < nodeCount; ++node)
+    {
+        if (node != committerNode)
+        {
+            nodes.push_back(node);
+        }
+    }
+
+    mybank::numa_placement placement{ committerNode, {}, {} };
+    if (committerNode < topology.nodeCpus.size())
+    {
+        const auto &cpus{ topology.nodeCpus[committerNode] };
+        placement.readerCpus.assign(cpus.begin(), cpus.begin() + static_cast<std::ptrdiff_t>(std::min<std::size_t>(cpus.size(), 2)));
+    }
+
+    for (const auto node : nodes)
+    {
+        const auto cpuCount{ (node < topology.nodeCpus.size()) ? topology.nodeCpus[node].size() : std::size_t{ 0 } };
+        const auto reserved{ (node == committerNode) ? std::size_t{ 2 } : std::size_t{ 0 } };
+        const auto freeCpus{ (cpuCount > reserved) ? cpuCount - reserved : std::size_t{ 0 } };
+
+        for (std::size_t cpu{ 0 }; cpu < freeCpus && placement.decoderNodes.size() < decodeThreads; ++cpu)
+        {
+            placement.decoderNodes.push_back(node);
+        }
+    }
+
+    for (std::size_t i{ 0 }; placement.decoderNodes.size() < decodeThreads; ++i)
+    {
+        placement.decoderNodes.push_back(nodes[i%nodes.size()]);
+    }
+
+    return placement;
+}
+
+auto mybank::current_numa_node(const mybank::numa_topology &topology) -> std::size_t
+{
+#ifdef __linux__
+    const auto cpu{ ::sched_getcpu() };
+    for (std::size_t node{ 0 }; node < topology.nodeCpus.size(); ++node)
+    {
+        const auto &cpus{ topology.nodeCpus[node] };
+        if (std::find(cpus.begin(), cpus.end(), cpu) != cpus.end())
+        {
+            return node;
+        }
+    }
+#endif
+    return 0;
+}
+
+auto mybank::memory_numa_node(const mybank::numa_topology &topology, const void *address) -> std::optional<std::size_t>
+{
+#ifdef __linux__
+    // get_mempolicy(2) without libnuma, the node of the page at the address
+    int nodeId{ -1 };
+    if (::syscall(SYS_get_mempolicy, &nodeId, nullptr, 0, address, MPOL_F_NODE | MPOL_F_ADDR) == 0)
+    {
+        const auto node{ std::find(topology.nodeIds.begin(), topology.nodeIds.end(), nodeId) };
+        if (node != topology.nodeIds.end())
+        {
+            return static_cast<std::size_t>(node - topology.nodeIds.begin());
+        }
+    }
+#endif
+    return std::nullopt;
+}
+
+auto mybank::current_thread_cpus() -> std::vector<int>
+{
+    std::vector<int> cpus{};
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (::sched_getaffinity(0, sizeof(set), &set) == 0)
+    {
+        for (auto cpu{ 0 }; cpu < CPU_SETSIZE; ++cpu)
+        {
+            if (CPU_ISSET(cpu, &set))
+            {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    return cpus;
+}
+
+auto mybank::pin_current_thread(const std::vector<int> &cpus) -> bool
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    auto any{ false };
+    for (const auto cpu : cpus)
+    {
+        if (cpu < CPU_SETSIZE)
+        {
+            CPU_SET(cpu, &set);
+            any = true;
+        }
+    }
+
+    return any && ::sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
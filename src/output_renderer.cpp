@@ -0,0 +1,112 @@
+#include <array>
+#include <limits>
+
+#include "output_renderer.h"
+
+namespace
+{
+
+constexpr std::size_t violationMasks{ std::size_t{ 1 } << mybank::violationCount };
+
+static_assert(violationMasks - 1 <= std::numeric_limits<mybank::violation_mask>::max());
+
+// JSON array of the violations of every mask, in the order they are reported
+auto violation_fragments() -> const std::array<std::string, violationMasks> &
+{
+    static const auto fragments{ []() {
+        std::array<std::string, violationMasks> arrays{};
+        for (std::size_t mask{ 0 }; mask < arrays.size(); ++mask)
+        {
+            arrays[mask] = json(mybank::to_violations(static_cast<mybank::violation_mask>(mask))).dump();
+        }
+        return arrays;
+    }() };
+
+    return fragments;
+}
+
+void append_limit(std::string &output, int64_t availableLimit)
+{
+    output += R"("availableLimit":)";
+    output += std::to_string(availableLimit);
+}
+
+} // namespace
+
+mybank::OutputRenderer::OutputRenderer(bool deltaOutput)
+        : deltaOutput_{ deltaOutput }
+{
+    violation_fragments();
+}
+
+void mybank::OutputRenderer::append(
+        std::string &output,
+        uint64_t inputLine,
+        mybank::OperationType type,
+        const mybank::account &account,
+        mybank::violation_mask violations)
+{
+    if (!deltaOutput_)
+    {
+        render_account(account);
+        output += accountFragment_;
+        output += violation_fragments()[violations];
+        output += "}\n";
+        return;
+    }
+
+    if (violations == 0 && type == mybank::OperationType::UNKNOWN)
+    {
+        return;
+    }
+
+    output += R"({"seq":)";
+    output += std::to_string(inputLine);
+
+    if (violations != 0)
+    {
+        output += R"(,"violations":)";
+        output += violation_fragments()[violations];
+        output += "}\n";
+    }
+    else if (type == mybank::OperationType::ACCOUNT)
+    {
+        output += R"(,"account":{"activeAccount":)";
+        output += account.activeAccount ? "true," : "false,";
+        append_limit(output, account.availableLimit);
+        output += "}}\n";
+    }
+    else
+    {
+        output += ',';
+        append_limit(output, account.availableLimit);
+        output += "}\n";
+    }
+}
+
+void mybank::OutputRenderer::append(
+        std::string &output,
+        uint64_t inputLine,
+        mybank::OperationType type,
+        const mybank::account &account,
+        const std::vector<mybank::Violation> &violations)
+{
+    append(output, inputLine, type, account, to_violation_mask(violations));
+}
+
+void mybank::OutputRenderer::render_account(const mybank::account &account)
+{
+    if (rendered_ && account.activeAccount == account_.activeAccount && account.availableLimit == account_.availableLimit)
+    {
+        return;
+    }
+
+    accountFragment_.clear();
+    accountFragment_ += R"({"account":{"activeAccount":)";
+    accountFragment_ += account.activeAccount ? "true," : "false,";
+    append_limit(accountFragment_, account.availableLimit);
+    accountFragment_ += R"(},"violations":)";
+
+    account_ = account;
+    rendered_ = true;
+}
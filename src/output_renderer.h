@@ -0,0 +1,50 @@
+#ifndef PROCESS_OPERATIONS_OUTPUT_RENDERER_H
+#define PROCESS_OPERATIONS_OUTPUT_RENDERER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "process_operations/process_operations.h"
+#include "json_utils.h"
+#include "validate_operations.h"
+
+namespace mybank
+{
+
+// Appends output lines from pre-rendered fragments: the account part, rendered again only when the
+// account changes, and the violations array of each violation mask, rendered once for all renderers.
+// Writes the same bytes as nlohmann's dump of {"account":...,"violations":[...]} followed by '\n'.
+class OutputRenderer
+{
+public:
+    explicit OutputRenderer(bool deltaOutput);
+
+    // Output line of the operation at the input line number, see process_options::deltaOutput
+    void append(
+            std::string &output,
+            uint64_t inputLine,
+            mybank::OperationType,
+            const mybank::account &,
+            mybank::violation_mask);
+
+    void append(
+            std::string &output,
+            uint64_t inputLine,
+            mybank::OperationType,
+            const mybank::account &,
+            const std::vector<mybank::Violation> &);
+
+private:
+    void render_account(const mybank::account &);
+
+    bool deltaOutput_;
+    bool rendered_{ false };
+    mybank::account account_{};
+    // {"account":{...},"violations":
+    std::string accountFragment_{};
+};
+
+} // namespace mybank
+
+#endif // PROCESS_OPERATIONS_OUTPUT_RENDERER_H
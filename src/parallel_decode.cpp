@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "process_operations/process_operations.h"
+#include "process_operations/metrics.h"
+#include "numa_placement.h"
+#include "output_renderer.h"
+#include "parallel_decode.h"
+#include "validate_operations.h"
+#include "json_utils.h"
+#include "process_operations/write_ahead_log.h"
+
+namespace
+{
+
+struct decode_chunk
+{
+    // Input line number of the first line
+    uint64_t firstLine;
+    std::vector<std::string> lines;
+    std::vector<std::optional<mybank::decoded_operation>> operations;
+    bool decoded;
+};
+
+} // namespace
+
+void mybank::process_transactions_parallel_decode(
+        mybank::account &account,
+        mybank::transaction_history &validTransactions,
+        mybank::history_index &index,
+        uint64_t &inputLines,
+        std::istream &in,
+        std::ostream &out,
+        const process_options &options)
+{
+    const auto maxChunksInFlight{ 2*options.decodeThreads };
+    const auto chunkLines{ std::max<std::size_t>(options.decodeChunkLines, 1) };
+
+    // Without a topology every thread is on a single node and none is pinned
+    const auto *topology{ options.numaTopology };
+    const auto pinned{ topology != nullptr && !topology->nodeCpus.empty() };
+
+    // The committer goes to the node of the account's memory, that of the calling thread when the system cannot tell
+    const auto placement{ pinned
+            ? plan_numa_placement(*topology, memory_numa_node(*topology, &account).value_or(current_numa_node(*topology)), options.decodeThreads)
+            : numa_placement{ 0, std::vector<std::size_t>(options.decodeThreads, 0), {} } };
+    const auto nodeCount{ pinned ? topology->nodeCpus.size() : std::size_t{ 1 } };
+
+    // Threads the system refuses to pin run unpinned, counted in the metrics
+    const auto pin = [&](const std::vector<int> &cpus) {
+        if (!pin_current_thread(cpus) && options.metrics != nullptr)
+        {
+            options.metrics->add(mybank::Metric::UNPINNED_THREADS);
+        }
+    };
+
+    std::mutex mutex{};
+    std::vector<std::condition_variable> chunkQueued(nodeCount);
+    std::condition_variable chunkDecoded{};
+    std::condition_variable chunkCommitted{};
+
+    // Chunks in input order, the committer always takes the front one,
+    // and the chunks routed to each node, decoded by the decoders placed there
+    std::deque<std::shared_ptr<decode_chunk>> chunks{};
+    std::vector<std::deque<std::shared_ptr<decode_chunk>>> chunksToDecode(nodeCount);
+    auto endOfInput{ false };
+
+    const auto decoder = [&](std::size_t node) {
+        if (pinned)
+        {
+            pin(topology->nodeCpus[node]);
+        }
+
+        auto &queue{ chunksToDecode[node] };
+        for (;;)
+        {
+            std::shared_ptr<decode_chunk> chunk{};
+            {
+                std::unique_lock<std::mutex> lock{ mutex };
+                chunkQueued[node].wait(lock, [&]() { return !queue.empty() || endOfInput; });
+                if (queue.empty())
+                {
+                    return;
+                }
+
+                chunk = std::move(queue.front());
+                queue.pop_front();
+            }
+
+            // First touched here, so the decoded operations are on the decoder's node
+            chunk->operations.reserve(chunk->lines.size());
+            for (const auto &inputLine : chunk->lines)
+            {
+                chunk->operations.push_back(decode_operation(inputLine));
+                record_decoded_line(chunk->operations.back(), options);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock{ mutex };
+                chunk->decoded = true;
+            }
+            chunkDecoded.notify_all();
+        }
+    };
+
+    const auto committer = [&]() {
+        if (pinned)
+        {
+            pin(topology->nodeCpus[placement.committerNode]);
+        }
+
+        std::vector<mybank::Violation> violations{};
+        mybank::OutputRenderer renderer{ options.deltaOutput };
+        std::string output{};
+
+        for (;;)
+        {
+            std::shared_ptr<decode_chunk> chunk{};
+            {
+                std::unique_lock<std::mutex> lock{ mutex };
+                chunkDecoded.wait(lock, [&]() { return (!chunks.empty() && chunks.front()->decoded) || (chunks.empty() && endOfInput); });
+                if (chunks.empty())
+                {
+                    break;
+                }
+
+                chunk = std::move(chunks.front());
+                chunks.pop_front();
+            }
+            chunkCommitted.notify_one();
+
+            for (std::size_t i{ 0 }; i < chunk->operations.size(); ++i)
+            {
+                const auto &operation{ chunk->operations[i] };
+                if (!operation.has_value())
+                {
+                    continue;
+                }
+
+                violations.clear();
+                authorize_operation(account, validTransactions, index, operation->view(), violations, options);
+
+                output.clear();
+                renderer.append(output, chunk->firstLine + i, operation->type, account, violations);
+                out << output;
+            }
+        }
+
+        if (options.wal != nullptr)
+        {
+            options.wal->commit();
+        }
+    };
+
+    std::vector<std::thread> decoders{};
+    for (const auto node : placement.decoderNodes)
+    {
+        decoders.emplace_back(decoder, node);
+    }
+    std::thread committerThread{ committer };
+
+    // The calling thread reads on the CPUs reserved for it, given back its own ones at the end
+    const auto callerCpus{ pinned ? current_thread_cpus() : std::vector<int>{} };
+    if (pinned)
+    {
+        pin(placement.readerCpus);
+    }
+
+    // Chunks go to the nodes in turn, as many to each as it has decoders
+    std::size_t chunkCount{ 0 };
+    for (auto readAll{ false }; !readAll;)
+    {
+        const auto node{ placement.decoderNodes[chunkCount++%placement.decoderNodes.size()] };
+
+        auto chunk{ std::make_shared<decode_chunk>() };
+        chunk->firstLine = inputLines + 1;
+        chunk->lines.reserve(chunkLines);
+
+        for (std::string inputLine; chunk->lines.size() < chunkLines;)
+        {
+            if (!std::getline(in, inputLine))
+            {
+                readAll = true;
+                break;
+            }
+            chunk->lines.push_back(std::move(inputLine));
+            ++inputLines;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock{ mutex };
+            chunkCommitted.wait(lock, [&]() { return chunks.size() < maxChunksInFlight; });
+
+            if (!chunk->lines.empty())
+            {
+                chunks.push_back(chunk);
+                chunksToDecode[node].push_back(std::move(chunk));
+            }
+            endOfInput = readAll;
+        }
+        chunkQueued[node].notify_one();
+    }
+
+    for (auto &queued : chunkQueued)
+    {
+        queued.notify_all();
+    }
+    chunkDecoded.notify_all();
+
+    for (auto &decoderThread : decoders)
+    {
+        decoderThread.join();
+    }
+    committerThread.join();
+
+    if (!callerCpus.empty())
+    {
+        pin_current_thread(callerCpus);
+    }
+}
@@ -0,0 +1,21 @@
+#ifndef PROCESS_OPERATIONS_PARALLEL_DECODE_H
+#define PROCESS_OPERATIONS_PARALLEL_DECODE_H
+
+namespace mybank
+{
+
+// Reads chunks of options.decodeChunkLines lines on the calling thread, decodes them on
+// options.decodeThreads worker threads and authorizes them in input order on a committer thread,
+// the threads placed on the nodes of options.numaTopology when set
+void process_transactions_parallel_decode(
+        account &,
+        transaction_history &,
+        history_index &,
+        uint64_t &inputLines,
+        std::istream &,
+        std::ostream &,
+        const process_options &);
+
+} // namespace mybank
+
+#endif // PROCESS_OPERATIONS_PARALLEL_DECODE_H
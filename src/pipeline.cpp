@@ -0,0 +1,104 @@
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "process_operations/process_operations.h"
+#include "output_renderer.h"
+#include "pipeline.h"
+#include "spsc_ring.h"
+#include "validate_operations.h"
+#include "json_utils.h"
+#include "process_operations/write_ahead_log.h"
+
+namespace
+{
+
+struct sequenced_operation
+{
+    uint64_t inputLine;
+    mybank::decoded_operation operation;
+};
+
+struct authorization_result
+{
+    uint64_t inputLine;
+    mybank::OperationType type;
+    mybank::account account;
+    mybank::violation_mask violations;
+    bool endOfStream;
+};
+
+} // namespace
+
+void mybank::process_transactions_pipelined(
+        mybank::account &account,
+        mybank::transaction_history &validTransactions,
+        mybank::history_index &index,
+        uint64_t &inputLines,
+        std::istream &in,
+        std::ostream &out,
+        const process_options &options)
+{
+    // An empty operation marks the end of the input
+    mybank::SpscRing<std::optional<sequenced_operation>> operations{ options.pipelineCapacity };
+    mybank::SpscRing<authorization_result> results{ options.pipelineCapacity };
+
+    std::thread authorizer{ [&]() {
+        std::vector<mybank::Violation> violations{};
+
+        for (std::optional<sequenced_operation> operation{};;)
+        {
+            operations.pop(operation);
+            if (!operation.has_value())
+            {
+                break;
+            }
+
+            violations.clear();
+            authorize_operation(account, validTransactions, index, operation->operation.view(), violations, options);
+            results.push({ operation->inputLine, operation->operation.type, account, to_violation_mask(violations), false });
+        }
+
+        if (options.wal != nullptr)
+        {
+            options.wal->commit();
+        }
+
+        results.push({ 0, mybank::OperationType::UNKNOWN, account, 0, true });
+    } };
+
+    std::thread writer{ [&]() {
+        mybank::OutputRenderer renderer{ options.deltaOutput };
+        std::string output{};
+
+        for (authorization_result result{};;)
+        {
+            results.pop(result);
+            if (result.endOfStream)
+            {
+                break;
+            }
+
+            output.clear();
+            renderer.append(output, result.inputLine, result.type, result.account, result.violations);
+            out << output;
+        }
+    } };
+
+    for (std::string inputLine; std::getline(in, inputLine);)
+    {
+        ++inputLines;
+        auto operation{ decode_operation(inputLine) };
+        record_decoded_line(operation, options);
+        if (operation.has_value())
+        {
+            operations.push(sequenced_operation{ inputLines, std::move(operation.value()) });
+        }
+    }
+
+    operations.push(std::nullopt);
+
+    authorizer.join();
+    writer.join();
+}
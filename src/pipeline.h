@@ -0,0 +1,20 @@
+#ifndef PROCESS_OPERATIONS_PIPELINE_H
+#define PROCESS_OPERATIONS_PIPELINE_H
+
+namespace mybank
+{
+
+// Reads and decodes on the calling thread, authorizes and writes on two other threads,
+// the stages being connected by SPSC rings of options.pipelineCapacity entries
+void process_transactions_pipelined(
+        account &,
+        transaction_history &,
+        history_index &,
+        uint64_t &inputLines,
+        std::istream &,
+        std::ostream &,
+        const process_options &);
+
+} // namespace mybank
+
+#endif // PROCESS_OPERATIONS_PIPELINE_H
@@ -1,39 +1,73 @@
-#include <cmath>
-#include <deque>
+#include <algorithm>
+#include <limits>
 #include <map>
+#include <utility>
 #include <vector>
 
 #include "process_operations/process_operations.h"
+#include "decode_kernels.h"
+#include "fast_decode.h"
+#include "history_index.h"
+#include "huge_page_arena.h"
+#include "output_renderer.h"
+#include "parallel_decode.h"
+#include "pipeline.h"
+#include "reorder_buffer.h"
 #include "validate_operations.h"
 #include "json_utils.h"
+#include "process_operations/metrics.h"
+#include "process_operations/write_ahead_log.h"
 
-void mybank::process_operations(std::istream &in, std::ostream &out)
+namespace
 {
-    auto account{ get_new_account(in, out) };
 
-    if (account.has_value())
+// Initial capacity of the reused line buffers, enough for the operations the producers send
+constexpr std::size_t lineReserve{ 256 };
+
+// Number of distinct violations, so collecting them never reallocates
+constexpr std::size_t violationsReserve{ mybank::violationCount };
+
+// Adds (or removes, with a negative sign) the transactions an authorizer keeps to the occupancy gauges
+void record_window(
+        const mybank::process_options &options,
+        const mybank::authorizer_state &state,
+        const mybank::history_index &index,
+        int64_t sign)
+{
+    if (options.metrics != nullptr)
     {
-        process_transactions(account.value(), in, out);
+        options.metrics->add(mybank::Metric::HISTORY_TRANSACTIONS, sign*static_cast<int64_t>(state.validTransactions.size()));
+        options.metrics->add(mybank::Metric::SPEND_WINDOW_TRANSACTIONS, sign*static_cast<int64_t>(index.spendWindow.size()));
     }
 }
 
-auto mybank::get_new_account(std::istream &in, std::ostream &out) -> std::optional<mybank::account>
+// Memory resource of the history and its index
+auto history_resource(const std::unique_ptr<mybank::HugePageArena> &arena) -> std::pmr::memory_resource *
+{
+    return (arena == nullptr) ? std::pmr::get_default_resource() : arena->resource();
+}
+
+} // namespace
+
+void mybank::process_operations(std::istream &in, std::ostream &out, const process_options &options)
+{
+    mybank::Authorizer authorizer{ options };
+    authorizer.process(in, out);
+}
+
+auto mybank::get_new_account(std::istream &in, std::ostream &out, const process_options &options)
+        -> std::optional<mybank::account>
 {
+    mybank::Authorizer authorizer{ options };
+
     for (std::string inputLine; std::getline(in, inputLine);)
     {
-        if (!json::accept(inputLine))
-        {
-            continue;
-        }
-
-        const auto inputJson = json::parse(inputLine);
+        const auto output{ authorizer.process(inputLine) };
 
-        if (is_valid_json_account(inputJson))
+        if (authorizer.state().account.has_value())
         {
-            const auto newAccount{ inputJson["account"].get<mybank::account>() };
-            const auto outputJson = mybank::build_output_json(newAccount, {});
-            out << outputJson << '\n';
-            return std::optional<mybank::account>{newAccount };
+            out << output;
+            return authorizer.state().account;
         }
     }
 
@@ -42,41 +76,497 @@ auto mybank::get_new_account(std::istream &in, std::ostream &out) -> std::option
 
 void mybank::process_transactions(mybank::account &account, std::istream &in, std::ostream &out)
 {
-    std::vector<mybank::Violation> violations{};
-    std::map<time_t, mybank::transaction> validTransactions{};
+    transaction_history validTransactions{};
+    process_transactions(account, validTransactions, in, out, {});
+}
 
-    for (std::string inputLine; std::getline(in, inputLine);)
+void mybank::process_transactions(
+        mybank::account &account,
+        mybank::transaction_history &validTransactions,
+        std::istream &in,
+        std::ostream &out,
+        const process_options &options)
+{
+    mybank::Authorizer authorizer{ options };
+    authorizer.restore(account, std::move(validTransactions));
+
+    authorizer.process(in, out);
+
+    auto state{ authorizer.release_state() };
+    account = state.account.value();
+    validTransactions = std::move(state.validTransactions);
+}
+
+mybank::Authorizer::Authorizer(const process_options &options)
+        : options_{ options },
+          arena_{ (options.hugePages == mybank::HugePages::OFF) ? nullptr : std::make_unique<mybank::HugePageArena>(options.hugePages) },
+          state_{ std::make_unique<mybank::authorizer_state>(
+                  mybank::authorizer_state{ std::nullopt, mybank::transaction_history{ history_resource(arena_) }, {} }) },
+          index_{ std::make_unique<mybank::history_index>(make_history_index(options.rules, {}, history_resource(arena_))) },
+          decoder_{ std::make_unique<mybank::OperationDecoder>() },
+          renderer_{ std::make_unique<mybank::OutputRenderer>(options.deltaOutput) }
+{
+    state_->violations.reserve(violationsReserve);
+    inputLine_.reserve(lineReserve);
+    output_.reserve(lineReserve);
+}
+
+mybank::Authorizer::Authorizer(Authorizer &&) noexcept = default;
+
+mybank::Authorizer &mybank::Authorizer::operator=(Authorizer &&other) noexcept
+{
+    if (this != &other)
     {
-        if (!json::accept(inputLine))
+        if (index_ != nullptr)
         {
-            continue;
+            record_window(options_, *state_, *index_, -1);
         }
 
-        violations.clear();
-        const auto inputJson = json::parse(inputLine);
+        // The history and index allocated from the arena are released before it is
+        options_ = std::move(other.options_);
+        state_ = std::move(other.state_);
+        index_ = std::move(other.index_);
+        arena_ = std::move(other.arena_);
+        decoder_ = std::move(other.decoder_);
+        renderer_ = std::move(other.renderer_);
+        inputLines_ = other.inputLines_;
+        inputLine_ = std::move(other.inputLine_);
+        output_ = std::move(other.output_);
+    }
+
+    return *this;
+}
+
+mybank::Authorizer::~Authorizer()
+{
+    // Moved from authorizers have no index and nothing left to count
+    if (index_ != nullptr)
+    {
+        record_window(options_, *state_, *index_, -1);
+    }
+}
+
+auto mybank::Authorizer::process(std::string_view inputLine) -> std::string_view
+{
+    output_.clear();
 
-        if (is_valid_json_account(inputJson))
+    ++inputLines_;
+    const auto *operation{ decoder_->decode(inputLine) };
+    record_decoded_line(operation, options_);
+    if (operation == nullptr)
+    {
+        return {};
+    }
+
+    state_->violations.clear();
+
+    if (!state_->account.has_value())
+    {
+        if (operation->type != mybank::OperationType::ACCOUNT)
         {
-            violations.push_back(mybank::Violation::ACCOUNT_ALREADY_INITIALIZED);
+            return {};
         }
-        else if (is_valid_json_transaction(inputJson))
+
+        state_->account = operation->account;
+        if (options_.wal != nullptr)
         {
-            const auto transaction{ inputJson["transaction"].get<mybank::transaction>() };
+            options_.wal->append(state_->account.value());
+        }
+    }
+    else
+    {
+        authorize_operation(state_->account.value(), state_->validTransactions, *index_, *operation, state_->violations, options_);
+    }
+
+    renderer_->append(output_, inputLines_, operation->type, state_->account.value(), state_->violations);
+    return output_;
+}
+
+auto mybank::Authorizer::process(const mybank::transaction &transaction) -> const std::vector<mybank::Violation> &
+{
+    state_->violations.clear();
+
+    if (state_->account.has_value())
+    {
+        authorize_transaction(state_->account.value(), state_->validTransactions, *index_, to_view(transaction), state_->violations, options_);
+    }
+
+    return state_->violations;
+}
+
+void mybank::Authorizer::process(std::istream &in, std::ostream &out)
+{
+    while (!state_->account.has_value() && std::getline(in, inputLine_))
+    {
+        out << process(inputLine_);
+    }
 
-            validate_active_account(account, violations);
-            validate_sufficient_limit(account, transaction, violations);
-            validate_transactions_small_interval(validTransactions, transaction, violations);
+    if (!state_->account.has_value())
+    {
+        return;
+    }
+
+    auto &account{ state_->account.value() };
 
-            if (violations.empty())
+    if (options_.reorderLatenessMillis > 0)
+    {
+        process_transactions_reordered(account, state_->validTransactions, *index_, inputLines_, in, out, options_);
+        return;
+    }
+
+    if (options_.pipelined)
+    {
+        process_transactions_pipelined(account, state_->validTransactions, *index_, inputLines_, in, out, options_);
+        return;
+    }
+
+    if (options_.decodeThreads > 0)
+    {
+        process_transactions_parallel_decode(account, state_->validTransactions, *index_, inputLines_, in, out, options_);
+        return;
+    }
+
+    while (std::getline(in, inputLine_))
+    {
+        out << process(inputLine_);
+    }
+
+    if (options_.wal != nullptr)
+    {
+        options_.wal->commit();
+    }
+}
+
+void mybank::Authorizer::restore(const mybank::account &account, mybank::transaction_history validTransactions)
+{
+    record_window(options_, *state_, *index_, -1);
+    state_->account = account;
+    // Moved node by node into the arena when the history uses one
+    state_->validTransactions = std::move(validTransactions);
+    *index_ = make_history_index(options_.rules, state_->validTransactions, history_resource(arena_));
+    record_window(options_, *state_, *index_, 1);
+}
+
+auto mybank::Authorizer::release_state() -> mybank::authorizer_state
+{
+    record_window(options_, *state_, *index_, -1);
+
+    // Assigned rather than move constructed, so the history returned never refers to the arena
+    mybank::authorizer_state state{};
+    state = std::move(*state_);
+
+    state_->account.reset();
+    state_->validTransactions.clear();
+    state_->violations.clear();
+    state_->violations.reserve(violationsReserve);
+    *index_ = make_history_index(options_.rules, {}, history_resource(arena_));
+    return state;
+}
+
+auto mybank::Authorizer::state() const -> const mybank::authorizer_state &
+{
+    return *state_;
+}
+
+auto mybank::Authorizer::options() const -> const mybank::process_options &
+{
+    return options_;
+}
+
+void mybank::authorize_operation(
+        mybank::account &account,
+        mybank::transaction_history &validTransactions,
+        mybank::history_index &index,
+        const mybank::operation_view &operation,
+        std::vector<Violation> &violations,
+        const process_options &options)
+{
+    switch (operation.type)
+    {
+        case mybank::OperationType::ACCOUNT:
+            violations.push_back(mybank::Violation::ACCOUNT_ALREADY_INITIALIZED);
+            if (options.metrics != nullptr)
             {
-                account.availableLimit -= transaction.amount;
-                validTransactions.emplace(transaction.timeInMillis, transaction);
+                options.metrics->add(mybank::Violation::ACCOUNT_ALREADY_INITIALIZED);
             }
+            break;
+        case mybank::OperationType::TRANSACTION:
+            authorize_transaction(account, validTransactions, index, operation.transaction, violations, options);
+            break;
+        case mybank::OperationType::UNKNOWN:
+            break;
+    }
+}
+
+void mybank::authorize_transaction(
+        mybank::account &account,
+        mybank::transaction_history &validTransactions,
+        mybank::history_index &index,
+        const mybank::transaction_view &transaction,
+        std::vector<Violation> &violations,
+        const process_options &options)
+{
+    const auto spendWindowSize{ index.spendWindow.size() };
+    const auto spendWindowEvictions{ index.spendWindow.evictions() };
+    auto keptInHistory{ false };
+
+    validate_active_account(account, violations);
+    validate_sufficient_limit(account, transaction, violations);
+    validate_spend_velocity(validTransactions, index, transaction, violations);
+    validate_transactions_small_interval(validTransactions, index, transaction, violations);
+    validate_velocity_rules(index, transaction, violations);
+
+    if (violations.empty())
+    {
+        account.availableLimit -= transaction.amount;
+
+        // Transactions at the time of an earlier one are debited but not kept in the history
+        // The only copy of the transaction's strings, made once it is admitted
+        auto position{ validTransactions.lower_bound(transaction.timeInMillis) };
+        keptInHistory = position == validTransactions.end() || position->first != transaction.timeInMillis;
+        if (keptInHistory)
+        {
+            position = validTransactions.emplace_hint(position, transaction.timeInMillis, to_transaction(transaction));
+            add_to_history_index(index, transaction);
+        }
+
+        if (options.wal != nullptr)
+        {
+            options.wal->append(keptInHistory ? position->second : to_transaction(transaction));
+        }
+    }
+
+    if (options.metrics != nullptr)
+    {
+        auto &metrics{ *options.metrics };
+        if (violations.empty())
+        {
+            metrics.add(mybank::Metric::ACCEPTED_TRANSACTIONS);
+        }
+
+        for (const auto violation : violations)
+        {
+            metrics.add(violation);
+        }
+
+        if (keptInHistory)
+        {
+            metrics.add(mybank::Metric::HISTORY_TRANSACTIONS);
+        }
+
+        // Only changed when the spend window rule is enabled
+        if (index.spendWindow.size() != spendWindowSize || index.spendWindow.evictions() != spendWindowEvictions)
+        {
+            metrics.add(mybank::Metric::SPEND_WINDOW_TRANSACTIONS,
+                        static_cast<int64_t>(index.spendWindow.size()) - static_cast<int64_t>(spendWindowSize));
+            metrics.add(mybank::Metric::SPEND_WINDOW_EVICTIONS,
+                        static_cast<int64_t>(index.spendWindow.evictions() - spendWindowEvictions));
+        }
+    }
+}
+
+void mybank::record_decoded_line(const mybank::operation_view *operation, const process_options &options)
+{
+    if (options.metrics == nullptr)
+    {
+        return;
+    }
+
+    if (operation == nullptr)
+    {
+        options.metrics->add(mybank::Metric::INVALID_LINES);
+        return;
+    }
+
+    options.metrics->add(mybank::Metric::OPERATIONS);
+    if (operation->type == mybank::OperationType::UNKNOWN)
+    {
+        options.metrics->add(mybank::Metric::UNKNOWN_OPERATIONS);
+    }
+}
+
+void mybank::record_decoded_line(const std::optional<mybank::decoded_operation> &operation, const process_options &options)
+{
+    if (options.metrics != nullptr)
+    {
+        const auto view{ operation.has_value() ? operation->view() : mybank::operation_view{} };
+        record_decoded_line(operation.has_value() ? &view : nullptr, options);
+    }
+}
+
+namespace
+{
+
+// Order in which authorize_operation reports violations
+constexpr mybank::Violation reportedViolations[]{
+    mybank::Violation::ACCOUNT_ALREADY_INITIALIZED,
+    mybank::Violation::ACCOUNT_NOT_ACTIVE,
+    mybank::Violation::INSUFFICIENT_LIMIT,
+    mybank::Violation::SPEND_VELOCITY,
+    mybank::Violation::DOUBLED_TRANSACTION,
+    mybank::Violation::HIGH_FREQUENCY_SMALL_INTERVAL,
+    mybank::Violation::VELOCITY_COUNT_LIMIT,
+    mybank::Violation::VELOCITY_AMOUNT_LIMIT
+};
+
+auto matches_velocity_rule(const mybank::velocity_rule &rule, const mybank::transaction_view &transaction) -> bool
+{
+    return (rule.merchant.empty() || rule.merchant == transaction.merchant) &&
+           transaction.amount >= rule.minAmount &&
+           transaction.amount <= rule.maxAmount;
+}
+
+// Valid transactions with a time in [first, last], counting stops at limit
+auto count_in_history(
+        const mybank::transaction_history &validTransactions,
+        time_t first,
+        time_t last,
+        std::size_t limit)
+        -> std::size_t
+{
+    std::size_t count{ 0 };
+    for (auto it{ validTransactions.lower_bound(first) };
+         it != validTransactions.end() && it->first <= last && count < limit;
+         ++it)
+    {
+        ++count;
+    }
+    return count;
+}
+
+// Same count, whole buckets taken from the ring and only the partial ones at both ends from the history
+auto count_transactions(
+        const mybank::transaction_history &validTransactions,
+        const mybank::TimeBuckets &buckets,
+        time_t first,
+        time_t last,
+        std::size_t limit)
+        -> std::size_t
+{
+    const auto firstBucket{ buckets.bucket_of(first) };
+    const auto lastBucket{ buckets.bucket_of(last) };
+    if (first > last || lastBucket - firstBucket < 2 || !buckets.covers(firstBucket))
+    {
+        return count_in_history(validTransactions, first, last, limit);
+    }
+
+    auto count{ count_in_history(validTransactions, first, buckets.bucket_start(firstBucket + 1) - 1, limit) };
+    for (auto bucket{ firstBucket + 1 }; bucket < lastBucket && count < limit; ++bucket)
+    {
+        count += buckets.count(bucket);
+    }
+    if (count < limit)
+    {
+        count += count_in_history(validTransactions, buckets.bucket_start(lastBucket), last, limit - count);
+    }
+    return std::min(count, limit);
+}
+
+// Whether a window of the interval, starting at a valid transaction with the new one's merchant and amount
+// closer than the interval to it, holds limit of those transactions
+auto exceeds_equal_transactions(
+        const mybank::history_index &index,
+        const mybank::transaction_view &transaction,
+        time_t interval,
+        std::size_t limit)
+        -> bool
+{
+    const auto merchant{ index.merchantIds.find(transaction.merchant) };
+    if (merchant == index.merchantIds.end())
+    {
+        return false;
+    }
+
+    const auto equalTimes{ index.equalTransactionTimes.find({ merchant->second, transaction.amount }) };
+    if (equalTimes == index.equalTransactionTimes.end())
+    {
+        return false;
+    }
+
+    // Times on the same side of the new one are all in one window
+    const auto time{ transaction.timeInMillis };
+    const auto &times{ equalTimes->second };
+    const auto first{ std::lower_bound(times.begin(), times.end(), time - interval + 1) };
+    const auto middle{ std::upper_bound(first, times.end(), time) };
+    const auto last{ std::lower_bound(middle, times.end(), time + interval) };
+    if (static_cast<std::size_t>(middle - first) >= limit || static_cast<std::size_t>(last - middle) >= limit)
+    {
+        return true;
+    }
+
+    // Otherwise there are less than 2*limit of them, compare each one with the one limit - 1 after it
+    for (auto windowStart{ first }; static_cast<std::size_t>(last - windowStart) >= limit; ++windowStart)
+    {
+        if (*(windowStart + (limit - 1)) - *windowStart <= interval)
+        {
+            return true;
         }
+    }
+    return false;
+}
 
-        const auto outputJson = mybank::build_output_json(account, violations);
-        out << outputJson << '\n';
+// Whether a window of the interval, starting at a valid transaction closer than the interval
+// to the time, holds limit of those valid transactions
+auto exceeds_frequency(
+        const mybank::transaction_history &validTransactions,
+        const mybank::TimeBuckets &buckets,
+        time_t time,
+        time_t interval,
+        std::size_t limit)
+        -> bool
+{
+    // Transactions on the same side of the time are all in one window
+    if (count_transactions(validTransactions, buckets, time - interval + 1, time, limit) == limit ||
+        count_transactions(validTransactions, buckets, time + 1, time + interval - 1, limit) == limit)
+    {
+        return true;
     }
+
+    // Otherwise there are less than 2*limit of them, compare each one with the one limit - 1 after it
+    auto windowStart{ validTransactions.lower_bound(time - interval + 1) };
+    auto windowEnd{ windowStart };
+    for (std::size_t i{ 1 }; i < limit; ++i)
+    {
+        if (windowEnd == validTransactions.end() || windowEnd->first >= time + interval)
+        {
+            return false;
+        }
+        ++windowEnd;
+    }
+
+    for (; windowEnd != validTransactions.end() && windowEnd->first < time + interval; ++windowStart, ++windowEnd)
+    {
+        if (windowEnd->first - windowStart->first <= interval)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+auto mybank::to_violation_mask(const std::vector<Violation> &violations) -> violation_mask
+{
+    violation_mask mask{ 0 };
+    for (const auto violation : violations)
+    {
+        mask |= static_cast<violation_mask>(1u << static_cast<unsigned>(violation));
+    }
+    return mask;
+}
+
+auto mybank::to_violations(violation_mask mask) -> std::vector<Violation>
+{
+    std::vector<mybank::Violation> violations{};
+    for (const auto violation : reportedViolations)
+    {
+        if (mask & (1u << static_cast<unsigned>(violation)))
+        {
+            violations.push_back(violation);
+        }
+    }
+    return violations;
 }
 
 void mybank::validate_active_account(
@@ -91,7 +581,7 @@ void mybank::validate_active_account(
 
 void mybank::validate_sufficient_limit(
         const account &account,
-        const transaction &transaction,
+        const transaction_view &transaction,
         std::vector<Violation> &violations)
 {
     if (account.availableLimit < transaction.amount)
@@ -100,63 +590,203 @@ void mybank::validate_sufficient_limit(
     }
 }
 
+void mybank::validate_spend_velocity(
+        const mybank::transaction_history &validTransactions,
+        const mybank::history_index &index,
+        const transaction_view &transaction,
+        std::vector<Violation> &violations)
+{
+    if (index.rules.spendWindowMillis == 0)
+    {
+        return;
+    }
+
+    // A total past the int64_t range exceeds any limit
+    auto spent{ transaction.amount };
+    auto exceeded{ false };
+
+    if (const auto total{ index.spendWindow.total_until(transaction.timeInMillis) }; total.has_value())
+    {
+        exceeded = __builtin_add_overflow(spent, total.value(), &spent);
+    }
+    else
+    {
+        // Late enough for its window to reach transactions expired from the spend window, summed from the history
+        const auto time{ transaction.timeInMillis };
+        for (auto validTransaction{ validTransactions.upper_bound(time - index.rules.spendWindowMillis) };
+             validTransaction != validTransactions.end() && validTransaction->first <= time && !exceeded;
+             ++validTransaction)
+        {
+            exceeded = __builtin_add_overflow(spent, validTransaction->second.amount, &spent);
+        }
+    }
+
+    if (exceeded || spent > index.rules.maxSpendInWindow)
+    {
+        violations.push_back(mybank::Violation::SPEND_VELOCITY);
+    }
+}
+
 void mybank::validate_transactions_small_interval(
-        const std::map<time_t, mybank::transaction> &validTransactions,
-        const transaction &transaction,
+        const mybank::transaction_history &validTransactions,
+        const mybank::history_index &index,
+        const transaction_view &transaction,
         std::vector<Violation> &violations)
 {
-    constexpr auto smallInterval{ 2*60*1000 }; // 2 minutes in milliseconds
+    const auto &rules{ index.rules };
 
-    double timediff;
-    auto maxTransactionsSmallInterval{ 0 };
-    auto maxEqualTransactionsSmallInterval{ 0 };
-    std::deque<mybank::transaction> transactionsSmallInterval{};
-    for (auto crit{ validTransactions.crbegin() };
-         crit != validTransactions.crend() &&
-         (timediff = difftime(transaction.timeInMillis, crit->first)) < smallInterval;
-         ++crit)
+    if (exceeds_equal_transactions(index, transaction, rules.smallIntervalMillis, rules.equalLimit))
     {
-        if (fabs(timediff) < smallInterval)
+        violations.push_back(mybank::Violation::DOUBLED_TRANSACTION);
+    }
+
+    if (exceeds_frequency(validTransactions, index.frequencyBuckets, transaction.timeInMillis, rules.smallIntervalMillis, rules.frequencyLimit))
+    {
+        violations.push_back(mybank::Violation::HIGH_FREQUENCY_SMALL_INTERVAL);
+    }
+}
+
+void mybank::validate_velocity_rules(
+        const mybank::history_index &index,
+        const transaction_view &transaction,
+        std::vector<Violation> &violations)
+{
+    auto countExceeded{ false };
+    auto amountExceeded{ false };
+
+    for (std::size_t i{ 0 }; i < index.velocity.size(); ++i)
+    {
+        const auto &rule{ index.rules.velocityRules[i] };
+        if (!matches_velocity_rule(rule, transaction))
         {
-            transactionsSmallInterval.push_back(crit->second);
-            while (difftime(transactionsSmallInterval.front().timeInMillis, crit->first) > smallInterval)
-            {
-                transactionsSmallInterval.pop_front();
-            }
+            continue;
+        }
 
-            auto currTransactionsSmallInterval{ 0 };
-            auto currEqualTransactionsSmallInterval{ 0 };
-            for (const auto &t : transactionsSmallInterval)
-            {
-                ++currTransactionsSmallInterval;
+        const mybank::AmountSeries *series{ &index.velocity[i].transactions };
+        if (rule.eachMerchant)
+        {
+            const auto merchant{ index.merchantIds.find(transaction.merchant) };
+            const auto merchantTransactions{ (merchant == index.merchantIds.end())
+                    ? index.velocity[i].merchantTransactions.end()
+                    : index.velocity[i].merchantTransactions.find(merchant->second) };
+            series = (merchantTransactions == index.velocity[i].merchantTransactions.end()) ? nullptr : &merchantTransactions->second;
+        }
 
-                if (t.merchant == transaction.merchant && t.amount == transaction.amount)
-                {
-                    ++currEqualTransactionsSmallInterval;
-                }
-            }
+        const auto totals{ (series == nullptr)
+                ? mybank::window_totals{ 0, 0 }
+                : series->totals(transaction.timeInMillis - rule.windowMillis, transaction.timeInMillis) };
 
-            if (currTransactionsSmallInterval > maxTransactionsSmallInterval)
-            {
-                maxTransactionsSmallInterval = currTransactionsSmallInterval;
-            }
+        // A total past the int64_t range exceeds any limit
+        int64_t totalAmount;
+        countExceeded = countExceeded || totals.count >= rule.maxTransactions;
+        amountExceeded = amountExceeded ||
+                         __builtin_add_overflow(totals.amount, transaction.amount, &totalAmount) ||
+                         totalAmount > rule.maxAmountSum;
+    }
 
-            if (currEqualTransactionsSmallInterval > maxEqualTransactionsSmallInterval)
-            {
-                maxEqualTransactionsSmallInterval = currEqualTransactionsSmallInterval;
-            }
+    if (countExceeded)
+    {
+        violations.push_back(mybank::Violation::VELOCITY_COUNT_LIMIT);
+    }
+
+    if (amountExceeded)
+    {
+        violations.push_back(mybank::Violation::VELOCITY_AMOUNT_LIMIT);
+    }
+}
+
+void mybank::add_to_history_index(mybank::history_index &index, const mybank::transaction_view &transaction)
+{
+    index.frequencyBuckets.add(transaction.timeInMillis);
+
+    if (index.rules.spendWindowMillis > 0)
+    {
+        index.spendWindow.add(transaction.timeInMillis, transaction.amount);
+    }
+
+    auto merchant{ index.merchantIds.find(transaction.merchant) };
+    if (merchant == index.merchantIds.end())
+    {
+        const auto &name{ index.merchantNames.emplace_back(transaction.merchant) };
+        merchant = index.merchantIds.emplace(name, static_cast<uint32_t>(index.merchantNames.size() - 1)).first;
+    }
+    const auto merchantId{ merchant->second };
+
+    // Appended in the common in order case
+    auto &times{ index.equalTransactionTimes[{ merchantId, transaction.amount }] };
+    times.insert(std::upper_bound(times.begin(), times.end(), transaction.timeInMillis), transaction.timeInMillis);
+
+    for (std::size_t i{ 0 }; i < index.velocity.size(); ++i)
+    {
+        const auto &rule{ index.rules.velocityRules[i] };
+        if (matches_velocity_rule(rule, transaction))
+        {
+            auto &series{ rule.eachMerchant ? index.velocity[i].merchantTransactions[merchantId] : index.velocity[i].transactions };
+            series.add(transaction.timeInMillis, transaction.amount);
         }
     }
+}
+
+auto mybank::compile_rules(const mybank::rule_options &rules) -> mybank::compiled_rules
+{
+    // The default 2 minutes interval is counted in 1 second buckets
+    constexpr time_t frequencyBucketsPerInterval{ 120 };
+
+    // Windows set in code rather than loaded are clamped to the bound load_rule_options enforces
+    const auto window = [](time_t windowMillis) {
+        return std::clamp<time_t>(windowMillis, 0, mybank::maxWindowMillis);
+    };
 
-    if (maxEqualTransactionsSmallInterval > 1)
+    const auto interval{ window(rules.smallIntervalMillis) };
+    const auto bucketMillis{ std::max<time_t>(interval/frequencyBucketsPerInterval, 1) };
+
+    const auto limit = [](std::size_t maxTransactions) {
+        return std::min(maxTransactions, std::numeric_limits<std::size_t>::max() - 1) + 1;
+    };
+
+    auto velocityRules{ rules.velocityRules };
+    for (auto &rule : velocityRules)
     {
-        violations.push_back(mybank::Violation::DOUBLED_TRANSACTION);
+        rule.windowMillis = window(rule.windowMillis);
     }
 
-    if (maxTransactionsSmallInterval > 2)
+    return mybank::compiled_rules{
+        interval,
+        limit(rules.maxTransactionsSmallInterval),
+        limit(rules.maxEqualTransactionsSmallInterval),
+        bucketMillis,
+        static_cast<std::size_t>(2*interval/bucketMillis + 2),
+        std::move(velocityRules),
+        window(rules.spendWindowMillis),
+        rules.maxSpendInWindow
+    };
+}
+
+auto mybank::make_history_index(
+        const mybank::rule_options &rules,
+        const mybank::transaction_history &validTransactions,
+        std::pmr::memory_resource *resource)
+        -> mybank::history_index
+{
+    const auto compiledRules{ compile_rules(rules) };
+    mybank::history_index index{
+        compiledRules,
+        mybank::TimeBuckets{ compiledRules.frequencyBucketMillis, compiledRules.frequencyBucketCount },
+        std::pmr::deque<std::pmr::string>{ resource },
+        std::pmr::unordered_map<std::string_view, uint32_t>{ resource },
+        decltype(history_index::equalTransactionTimes){ resource },
+        {},
+        mybank::SpendWindow{ compiledRules.spendWindowMillis, resource }
+    };
+    for (std::size_t i{ 0 }; i < compiledRules.velocityRules.size(); ++i)
     {
-        violations.push_back(mybank::Violation::HIGH_FREQUENCY_SMALL_INTERVAL);
+        index.velocity.push_back({ mybank::AmountSeries{ resource }, decltype(velocity_index::merchantTransactions){ resource } });
     }
+    for (const auto &[timeInMillis, transaction] : validTransactions)
+    {
+        add_to_history_index(index, to_view(transaction));
+    }
+    return index;
 }
 
 void mybank::to_json(json &j, const account &a)
@@ -187,25 +817,81 @@ void mybank::from_json(const json& j, transaction &t)
     j.at("amount").get_to(t.amount);
     j.at("merchant").get_to(t.merchant);
     j.at("time").get_to(t.timeIso8601);
+    t.timeInMillis = iso8601_to_millis(t.timeIso8601);
+}
 
-    tm time{};
-    memset(&time, 0, sizeof(tm));
-    strptime(t.timeIso8601.c_str(), "%Y-%m-%dT%H:%M:%SZ", &time);
-    const auto milliseconds{ (t.timeIso8601.length() > 20) ? std::strtol(&t.timeIso8601[20], nullptr, 10) : 0 };
-    t.timeInMillis = mktime(&time)*1000 + milliseconds;
+auto mybank::to_view(const mybank::transaction &transaction) -> mybank::transaction_view
+{
+    return { transaction.amount, transaction.merchant, transaction.timeIso8601, transaction.timeInMillis };
 }
 
-auto mybank::build_output_json(
-        const mybank::account &account,
-        const std::vector<mybank::Violation> &violations)
-        -> json
+auto mybank::to_transaction(const mybank::transaction_view &transaction) -> mybank::transaction
 {
-    return json{
-        { "account", account },
-        { "violations", violations }
+    return {
+        transaction.amount,
+        std::string{ transaction.merchant },
+        std::string{ transaction.timeIso8601 },
+        transaction.timeInMillis
     };
 }
 
+auto mybank::decoded_operation::view() const -> mybank::operation_view
+{
+    return { type, account, to_view(transaction) };
+}
+
+auto mybank::OperationDecoder::decode(std::string_view inputLine) -> const mybank::operation_view *
+{
+    operation_.type = mybank::OperationType::UNKNOWN;
+
+    if (decode_operation_fast(inputLine, operation_))
+    {
+        return &operation_;
+    }
+
+    // Parsed once without exceptions, malformed lines yield a discarded value
+    const auto inputJson = json::parse(inputLine.begin(), inputLine.end(), nullptr, false);
+    if (inputJson.is_discarded())
+    {
+        return nullptr;
+    }
+
+    if (is_valid_json_account(inputJson))
+    {
+        operation_.type = mybank::OperationType::ACCOUNT;
+        inputJson["account"].get_to(operation_.account);
+    }
+    else if (is_valid_json_transaction(inputJson))
+    {
+        // The strings were unescaped into the document, which goes away with this call
+        const auto &transactionJson{ inputJson["transaction"] };
+        merchant_ = transactionJson["merchant"].get_ref<const std::string &>();
+        timeIso8601_ = transactionJson["time"].get_ref<const std::string &>();
+
+        operation_.type = mybank::OperationType::TRANSACTION;
+        operation_.transaction = {
+            transactionJson["amount"].get<int64_t>(),
+            merchant_,
+            timeIso8601_,
+            iso8601_to_millis(timeIso8601_)
+        };
+    }
+
+    return &operation_;
+}
+
+auto mybank::decode_operation(std::string_view inputLine) -> std::optional<mybank::decoded_operation>
+{
+    mybank::OperationDecoder decoder{};
+    const auto *operation{ decoder.decode(inputLine) };
+    if (operation == nullptr)
+    {
+        return std::nullopt;
+    }
+
+    return mybank::decoded_operation{ operation->type, operation->account, to_transaction(operation->transaction) };
+}
+
 auto mybank::is_valid_json_account(const json &j) -> bool
 {
     return (j.is_object() &&
@@ -221,7 +907,9 @@ auto mybank::is_valid_json_transaction(const json &j) -> bool
     return (j.is_object() &&
             j.find("transaction") != j.end() &&
             j["transaction"].find("merchant") != j["transaction"].end() &&
+            j["transaction"]["merchant"].is_string() &&
             j["transaction"].find("amount") != j["transaction"].end() &&
             j["transaction"]["amount"].is_number_integer() &&
-            j["transaction"].find("time") != j["transaction"].end());
+            j["transaction"].find("time") != j["transaction"].end() &&
+            j["transaction"]["time"].is_string());
 }
@@ -0,0 +1,102 @@
+#include <deque>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "process_operations/process_operations.h"
+#include "output_renderer.h"
+#include "reorder_buffer.h"
+#include "validate_operations.h"
+#include "json_utils.h"
+#include "process_operations/write_ahead_log.h"
+
+void mybank::process_transactions_reordered(
+        mybank::account &account,
+        mybank::transaction_history &validTransactions,
+        mybank::history_index &index,
+        uint64_t &inputLines,
+        std::istream &in,
+        std::ostream &out,
+        const process_options &options)
+{
+    std::vector<mybank::Violation> violations{};
+    mybank::OutputRenderer renderer{ options.deltaOutput };
+    mybank::ReorderBuffer reorderBuffer{ options.reorderLatenessMillis, options.reorderCapacity };
+
+    // Output lines indexed by arrival, written as soon as every earlier arrival is decided.
+    // Lines that are not transactions are rendered only then, with the account at that point.
+    struct pending_output
+    {
+        bool deferred;
+        uint64_t inputLine;
+        mybank::OperationType type;
+        std::vector<mybank::Violation> violations;
+        // With its '\n', empty when the operation writes nothing
+        std::optional<std::string> line;
+    };
+
+    uint64_t firstPendingArrival{ 0 };
+    std::deque<pending_output> pendingOutputs{};
+
+    const auto flush = [&]() {
+        while (!pendingOutputs.empty())
+        {
+            auto &output{ pendingOutputs.front() };
+            if (output.deferred)
+            {
+                output.line.emplace();
+                renderer.append(output.line.value(), output.inputLine, output.type, account, output.violations);
+            }
+            else if (!output.line.has_value())
+            {
+                break;
+            }
+
+            out << output.line.value();
+            pendingOutputs.pop_front();
+            ++firstPendingArrival;
+        }
+    };
+
+    const auto authorize = [&](uint64_t arrival, const mybank::transaction &transaction) {
+        violations.clear();
+        authorize_transaction(account, validTransactions, index, to_view(transaction), violations, options);
+
+        auto &output{ pendingOutputs[arrival - firstPendingArrival] };
+        output.line.emplace();
+        renderer.append(output.line.value(), output.inputLine, output.type, account, violations);
+        flush();
+    };
+
+    for (std::string inputLine; std::getline(in, inputLine);)
+    {
+        ++inputLines;
+        const auto operation{ decode_operation(inputLine) };
+        record_decoded_line(operation, options);
+        if (!operation.has_value())
+        {
+            continue;
+        }
+
+        if (operation->type == mybank::OperationType::TRANSACTION)
+        {
+            const auto arrival{ firstPendingArrival + pendingOutputs.size() };
+            pendingOutputs.push_back({ false, inputLines, mybank::OperationType::TRANSACTION, {}, std::nullopt });
+            reorderBuffer.push(arrival, operation->transaction);
+            reorderBuffer.release_ready(authorize);
+        }
+        else
+        {
+            pendingOutputs.push_back({ true, inputLines, operation->type, {}, std::nullopt });
+            authorize_operation(account, validTransactions, index, operation->view(), pendingOutputs.back().violations, options);
+            flush();
+        }
+    }
+
+    reorderBuffer.release_all(authorize);
+
+    if (options.wal != nullptr)
+    {
+        options.wal->commit();
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef PROCESS_OPERATIONS_REORDER_BUFFER_H
+#define PROCESS_OPERATIONS_REORDER_BUFFER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <utility>
+
+namespace mybank
+{
+
+// Bounded buffer releasing transactions in time order once they are older than
+// the newest time seen minus the lateness window (or when the capacity is exceeded).
+// The lateness is clamped to [0, maxWindowMillis] so the watermark cannot overflow.
+class ReorderBuffer
+{
+public:
+    ReorderBuffer(time_t latenessMillis, std::size_t capacity)
+            : latenessMillis_{ std::clamp<time_t>(latenessMillis, 0, mybank::maxWindowMillis) },
+              capacity_{ capacity }
+    {
+    }
+
+    void push(uint64_t arrival, const mybank::transaction &transaction)
+    {
+        if (transaction.timeInMillis > newestTime_)
+        {
+            newestTime_ = transaction.timeInMillis;
+        }
+
+        pending_.emplace(std::make_pair(transaction.timeInMillis, arrival), transaction);
+    }
+
+    // Calls release(arrival, transaction) for every transaction ready to be authorized
+    template<typename Release>
+    void release_ready(Release &&release)
+    {
+        if (pending_.empty())
+        {
+            return;
+        }
+
+        const auto watermark{ newestTime_ - latenessMillis_ };
+
+        while (!pending_.empty() &&
+               (pending_.begin()->first.first <= watermark || pending_.size() > capacity_))
+        {
+            release_front(release);
+        }
+    }
+
+    template<typename Release>
+    void release_all(Release &&release)
+    {
+        while (!pending_.empty())
+        {
+            release_front(release);
+        }
+    }
+
+private:
+    template<typename Release>
+    void release_front(Release &release)
+    {
+        auto node{ pending_.extract(pending_.begin()) };
+        release(node.key().second, node.mapped());
+    }
+
+    time_t latenessMillis_;
+    std::size_t capacity_;
+    time_t newestTime_{ std::numeric_limits<time_t>::min() };
+    std::map<std::pair<time_t, uint64_t>, mybank::transaction> pending_{};
+};
+
+void process_transactions_reordered(
+        account &,
+        transaction_history &,
+        history_index &,
+        uint64_t &inputLines,
+        std::istream &,
+        std::ostream &,
+        const process_options &);
+
+} // namespace mybank
+
+#endif // PROCESS_OPERATIONS_REORDER_BUFFER_H
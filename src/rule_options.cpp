@@ -0,0 +1,137 @@
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "process_operations/process_operations.h"
+#include "json_utils.h"
+
+namespace
+{
+
+// Windows past mybank::maxWindowMillis are rejected like values of the wrong type
+auto read_window_millis(const json &value, time_t &windowMillis) -> bool
+{
+    if (!value.is_number_unsigned() || value.get<uint64_t>() > static_cast<uint64_t>(mybank::maxWindowMillis))
+    {
+        return false;
+    }
+
+    windowMillis = value.get<time_t>();
+    return true;
+}
+
+auto read_velocity_rule(const json &ruleJson, mybank::velocity_rule &rule) -> bool
+{
+    if (!ruleJson.is_object())
+    {
+        return false;
+    }
+
+    for (const auto &[key, value] : ruleJson.items())
+    {
+        if (key == "merchant" && value.is_string())
+        {
+            rule.merchant = value.get<std::string>();
+        }
+        else if (key == "eachMerchant" && value.is_boolean())
+        {
+            rule.eachMerchant = value.get<bool>();
+        }
+        else if (key == "minAmount" && value.is_number_integer())
+        {
+            rule.minAmount = value.get<int64_t>();
+        }
+        else if (key == "maxAmount" && value.is_number_integer())
+        {
+            rule.maxAmount = value.get<int64_t>();
+        }
+        else if (key == "windowMillis")
+        {
+            if (!read_window_millis(value, rule.windowMillis))
+            {
+                return false;
+            }
+        }
+        else if (key == "maxTransactions" && value.is_number_unsigned())
+        {
+            rule.maxTransactions = value.get<std::size_t>();
+        }
+        else if (key == "maxAmountSum" && value.is_number_integer())
+        {
+            rule.maxAmountSum = value.get<int64_t>();
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+auto mybank::load_rule_options(const std::string &path) -> std::optional<mybank::rule_options>
+{
+    std::ifstream file{ path };
+    if (!file)
+    {
+        return std::nullopt;
+    }
+
+    const std::string content{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+    const auto rulesJson = json::parse(content, nullptr, false);
+    if (rulesJson.is_discarded() || !rulesJson.is_object())
+    {
+        return std::nullopt;
+    }
+
+    mybank::rule_options rules{};
+
+    for (const auto &[key, value] : rulesJson.items())
+    {
+        if (key == "smallIntervalMillis")
+        {
+            if (!read_window_millis(value, rules.smallIntervalMillis))
+            {
+                return std::nullopt;
+            }
+        }
+        else if (key == "maxTransactionsSmallInterval" && value.is_number_unsigned())
+        {
+            rules.maxTransactionsSmallInterval = value.get<std::size_t>();
+        }
+        else if (key == "maxEqualTransactionsSmallInterval" && value.is_number_unsigned())
+        {
+            rules.maxEqualTransactionsSmallInterval = value.get<std::size_t>();
+        }
+        else if (key == "spendWindowMillis")
+        {
+            if (!read_window_millis(value, rules.spendWindowMillis))
+            {
+                return std::nullopt;
+            }
+        }
+        else if (key == "maxSpendInWindow" && value.is_number_integer())
+        {
+            rules.maxSpendInWindow = value.get<int64_t>();
+        }
+        else if (key == "velocityRules" && value.is_array())
+        {
+            for (const auto &ruleJson : value)
+            {
+                rules.velocityRules.emplace_back();
+                if (!read_velocity_rule(ruleJson, rules.velocityRules.back()))
+                {
+                    return std::nullopt;
+                }
+            }
+        }
+        else
+        {
+            return std::nullopt;
+        }
+    }
+
+    return std::optional<mybank::rule_options>{ rules };
+}
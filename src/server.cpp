@@ -0,0 +1,364 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "process_operations/server.h"
+#include "process_operations/write_ahead_log.h"
+
+namespace
+{
+
+constexpr std::size_t readChunkSize{ 64*1024 };
+constexpr int maxEvents{ 64 };
+
+struct connection
+{
+    std::string input;
+    std::string output;
+    bool closed;
+    uint32_t events;
+};
+
+auto open_listening_socket(const mybank::server_options &options) -> int
+{
+    const auto isUnix{ !options.unixSocketPath.empty() };
+    const auto fd{ ::socket(isUnix ? AF_UNIX : AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0) };
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    auto bound{ false };
+    if (isUnix)
+    {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (options.unixSocketPath.size() < sizeof(address.sun_path))
+        {
+            std::memcpy(address.sun_path, options.unixSocketPath.c_str(), options.unixSocketPath.size() + 1);
+            ::unlink(options.unixSocketPath.c_str());
+            bound = ::bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0;
+        }
+    }
+    else
+    {
+        const int reuse{ 1 };
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(options.tcpPort);
+        bound = ::bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0;
+    }
+
+    if (!bound || ::listen(fd, options.backlog) != 0)
+    {
+        ::close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+} // namespace
+
+struct mybank::AuthorizerServer::impl
+{
+    mybank::server_options serverOptions;
+    mybank::process_options processOptions;
+
+    int listenFd{ -1 };
+    int epollFd{ -1 };
+    int stopFd{ -1 };
+    uint16_t port{ 0 };
+
+    mybank::Authorizer authorizer;
+
+    std::unordered_map<int, connection> connections{};
+
+    impl(const mybank::server_options &serverOptions, const mybank::process_options &processOptions)
+            : serverOptions{ serverOptions },
+              processOptions{ processOptions },
+              authorizer{ processOptions }
+    {
+    }
+
+    ~impl()
+    {
+        for (const auto &[fd, connection] : connections)
+        {
+            ::close(fd);
+        }
+
+        for (const auto fd : { listenFd, epollFd, stopFd })
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+        }
+
+        if (!serverOptions.unixSocketPath.empty() && listenFd >= 0)
+        {
+            ::unlink(serverOptions.unixSocketPath.c_str());
+        }
+    }
+
+    void accept_connections()
+    {
+        for (;;)
+        {
+            const auto fd{ ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC) };
+            if (fd < 0)
+            {
+                return;
+            }
+
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLRDHUP;
+            event.data.fd = fd;
+            ::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+
+            connections.emplace(fd, connection{ {}, {}, false, EPOLLIN | EPOLLRDHUP });
+        }
+    }
+
+    // Returns false when the connection is dropped for a line past the maximum length
+    auto read_connection(int fd, connection &client) -> bool
+    {
+        char buffer[readChunkSize];
+        std::size_t budget{ std::max<std::size_t>(serverOptions.readBudget, 1) };
+
+        // Past the high-water mark the rest stays in the socket, so a client not reading its answers is throttled.
+        // Past the budget it is left for a later readiness event, so a client sending lines without answers
+        // (e.g. invalid ones) does not keep the event loop from the other connections.
+        while (client.output.size() < serverOptions.outputHighWaterMark && budget > 0)
+        {
+            const auto received{ ::read(fd, buffer, std::min(sizeof(buffer), budget)) };
+            if (received > 0)
+            {
+                budget -= static_cast<std::size_t>(received);
+                client.input.append(buffer, static_cast<std::size_t>(received));
+                if (!process_lines(client))
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            if (received < 0 && errno == EINTR)
+            {
+                continue;
+            }
+
+            if (received == 0 || errno != EAGAIN)
+            {
+                client.closed = true;
+            }
+            break;
+        }
+
+        // A last line without newline is complete once the client stops sending
+        if (client.closed && !client.input.empty())
+        {
+            client.output += authorizer.process(client.input);
+            client.input.clear();
+        }
+
+        if (processOptions.wal != nullptr)
+        {
+            processOptions.wal->commit();
+        }
+        return true;
+    }
+
+    // Answers the complete lines received, keeping a partial last one, false for a line too long
+    auto process_lines(connection &client) -> bool
+    {
+        std::size_t lineStart{ 0 };
+        for (auto lineEnd{ client.input.find('\n') }; lineEnd != std::string::npos; lineEnd = client.input.find('\n', lineStart))
+        {
+            if (lineEnd - lineStart > serverOptions.maxLineLength)
+            {
+                return false;
+            }
+
+            client.output += authorizer.process(std::string_view{ client.input }.substr(lineStart, lineEnd - lineStart));
+            lineStart = lineEnd + 1;
+        }
+        client.input.erase(0, lineStart);
+
+        return client.input.size() <= serverOptions.maxLineLength;
+    }
+
+    // Returns false once the connection can be closed
+    auto write_connection(int fd, connection &client) -> bool
+    {
+        std::size_t written{ 0 };
+        while (written < client.output.size())
+        {
+            const auto sent{ ::send(fd, client.output.data() + written, client.output.size() - written, MSG_NOSIGNAL) };
+            if (sent < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                if (errno != EAGAIN)
+                {
+                    return false;
+                }
+                break;
+            }
+            written += static_cast<std::size_t>(sent);
+        }
+        client.output.erase(0, written);
+
+        if (client.closed && client.output.empty())
+        {
+            return false;
+        }
+
+        // Only waits for writability while output is pending, and only for that once the client is gone
+        // or while the output is past the high-water mark
+        const auto reading{ !client.closed && client.output.size() < serverOptions.outputHighWaterMark };
+        const auto events{ (reading ? (EPOLLIN | EPOLLRDHUP) : 0) | (client.output.empty() ? 0 : EPOLLOUT) };
+        if (events != client.events)
+        {
+            epoll_event event{};
+            event.events = events;
+            event.data.fd = fd;
+            ::epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event);
+            client.events = events;
+        }
+        return true;
+    }
+
+    void close_connection(int fd)
+    {
+        ::epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        connections.erase(fd);
+    }
+};
+
+auto mybank::AuthorizerServer::open(const server_options &serverOptions, const process_options &processOptions)
+        -> std::optional<AuthorizerServer>
+{
+    auto state{ std::make_unique<impl>(serverOptions, processOptions) };
+
+    state->listenFd = open_listening_socket(serverOptions);
+    state->epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    state->stopFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (state->listenFd < 0 || state->epollFd < 0 || state->stopFd < 0)
+    {
+        return std::nullopt;
+    }
+
+    if (serverOptions.unixSocketPath.empty())
+    {
+        sockaddr_in address{};
+        socklen_t addressLength{ sizeof(address) };
+        ::getsockname(state->listenFd, reinterpret_cast<sockaddr *>(&address), &addressLength);
+        state->port = ntohs(address.sin_port);
+    }
+
+    for (const auto fd : { state->listenFd, state->stopFd })
+    {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (::epoll_ctl(state->epollFd, EPOLL_CTL_ADD, fd, &event) != 0)
+        {
+            return std::nullopt;
+        }
+    }
+
+    return std::optional<AuthorizerServer>{ AuthorizerServer{ std::move(state) } };
+}
+
+mybank::AuthorizerServer::AuthorizerServer(std::unique_ptr<impl> state)
+        : impl_{ std::move(state) }
+{
+}
+
+mybank::AuthorizerServer::AuthorizerServer(AuthorizerServer &&) noexcept = default;
+auto mybank::AuthorizerServer::operator=(AuthorizerServer &&) noexcept -> AuthorizerServer & = default;
+mybank::AuthorizerServer::~AuthorizerServer() = default;
+
+auto mybank::AuthorizerServer::port() const -> uint16_t
+{
+    return impl_->port;
+}
+
+void mybank::AuthorizerServer::run()
+{
+    epoll_event events[maxEvents];
+
+    for (;;)
+    {
+        const auto ready{ ::epoll_wait(impl_->epollFd, events, maxEvents, -1) };
+        if (ready < 0 && errno != EINTR)
+        {
+            return;
+        }
+
+        for (auto i{ 0 }; i < ready; ++i)
+        {
+            const auto fd{ events[i].data.fd };
+
+            if (fd == impl_->stopFd)
+            {
+                uint64_t value;
+                while (::read(impl_->stopFd, &value, sizeof(value)) < 0 && errno == EINTR)
+                {
+                }
+                return;
+            }
+
+            if (fd == impl_->listenFd)
+            {
+                impl_->accept_connections();
+                continue;
+            }
+
+            const auto client{ impl_->connections.find(fd) };
+            if (client == impl_->connections.end())
+            {
+                continue;
+            }
+
+            if (!client->second.closed && (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) &&
+                !impl_->read_connection(fd, client->second))
+            {
+                impl_->close_connection(fd);
+                continue;
+            }
+
+            if (!impl_->write_connection(fd, client->second))
+            {
+                impl_->close_connection(fd);
+            }
+        }
+    }
+}
+
+void mybank::AuthorizerServer::stop()
+{
+    const uint64_t value{ 1 };
+    while (::write(impl_->stopFd, &value, sizeof(value)) < 0 && errno == EINTR)
+    {
+    }
+}
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <numeric>
+
+#include "spend_window.h"
+
+namespace
+{
+
+template<typename Iterator>
+auto sum_amounts(Iterator first, Iterator last) -> int64_t
+{
+    return std::accumulate(first, last, int64_t{ 0 }, [](int64_t total, const auto &transaction) {
+        return total + transaction.amount;
+    });
+}
+
+} // namespace
+
+mybank::SpendWindow::SpendWindow(time_t windowMillis, const allocator_type &allocator)
+        : windowMillis_{ windowMillis },
+          transactions_{ allocator }
+{
+}
+
+void mybank::SpendWindow::add(time_t timeInMillis, int64_t amount)
+{
+    if (timeInMillis >= newestTime_)
+    {
+        // The common in order case, appended
+        transactions_.push_back({ timeInMillis, amount });
+        newestTime_ = timeInMillis;
+    }
+    else if (timeInMillis <= newestTime_ - windowMillis_)
+    {
+        // Late past the window, expired as soon as it is added
+        expire(timeInMillis);
+        return;
+    }
+    else
+    {
+        const auto position{ std::upper_bound(transactions_.begin(), transactions_.end(), timeInMillis,
+                                              [](time_t time, const entry &transaction) { return time < transaction.timeInMillis; }) };
+        transactions_.insert(position, { timeInMillis, amount });
+    }
+
+    total_ += amount;
+
+    while (!transactions_.empty() && transactions_.front().timeInMillis <= newestTime_ - windowMillis_)
+    {
+        total_ -= transactions_.front().amount;
+        expire(transactions_.front().timeInMillis);
+        transactions_.pop_front();
+    }
+}
+
+auto mybank::SpendWindow::total_until(time_t timeInMillis) const -> std::optional<int64_t>
+{
+    const auto after{ timeInMillis - windowMillis_ };
+    if (expiredTime_ > after)
+    {
+        return std::nullopt;
+    }
+
+    const auto later = [](time_t time, const entry &transaction) { return time < transaction.timeInMillis; };
+    const auto first{ std::upper_bound(transactions_.begin(), transactions_.end(), after, later) };
+    const auto last{ std::upper_bound(first, transactions_.end(), timeInMillis, later) };
+
+    // Sums the fewest transactions, those left out of the window when it is near the newest time
+    if (static_cast<std::size_t>(last - first) <= transactions_.size()/2)
+    {
+        return sum_amounts(first, last);
+    }
+    return total_ - sum_amounts(transactions_.begin(), first) - sum_amounts(last, transactions_.end());
+}
+
+void mybank::SpendWindow::expire(time_t timeInMillis)
+{
+    expiredTime_ = std::max(expiredTime_, timeInMillis);
+    ++evictions_;
+}
@@ -0,0 +1,57 @@
+#ifndef PROCESS_OPERATIONS_SPEND_WINDOW_H
+#define PROCESS_OPERATIONS_SPEND_WINDOW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <limits>
+#include <memory_resource>
+#include <optional>
+
+namespace mybank
+{
+
+// Transactions in the window of windowMillis up to the newest time added, with the running total
+// of their amounts. Older transactions are expired as the window moves forward, late ones still in
+// the window are inserted in time order.
+class SpendWindow
+{
+public:
+    // Allocates from the memory resource of the history index holding the window
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    explicit SpendWindow(time_t windowMillis, const allocator_type & = {});
+
+    void add(time_t timeInMillis, int64_t amount);
+
+    // Total in the window up to the time, std::nullopt when that window reaches back to expired transactions
+    auto total_until(time_t timeInMillis) const -> std::optional<int64_t>;
+
+    // Transactions in the window up to the newest time added
+    auto size() const -> std::size_t { return transactions_.size(); }
+
+    // Transactions expired from the window so far, late ones older than it included
+    auto evictions() const -> uint64_t { return evictions_; }
+
+private:
+    struct entry
+    {
+        time_t timeInMillis;
+        int64_t amount;
+    };
+
+    void expire(time_t timeInMillis);
+
+    time_t windowMillis_;
+    time_t newestTime_{ std::numeric_limits<time_t>::min() };
+    // Newest time of an expired transaction, totals of windows after it are complete
+    time_t expiredTime_{ std::numeric_limits<time_t>::min() };
+    int64_t total_{ 0 };
+    uint64_t evictions_{ 0 };
+    std::pmr::deque<entry> transactions_;
+};
+
+} // namespace mybank
+
+#endif // PROCESS_OPERATIONS_SPEND_WINDOW_H
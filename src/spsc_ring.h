@@ -0,0 +1,159 @@
+#ifndef PROCESS_OPERATIONS_SPSC_RING_H
+#define PROCESS_OPERATIONS_SPSC_RING_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace mybank
+{
+
+constexpr std::size_t cacheLineSize{ 64 };
+
+// Lock-free bounded ring for exactly one producer and one consumer thread.
+// Each side keeps its index and a cached copy of the other side's index on its own
+// cache line, so the threads only touch the shared line when the cached copy runs out.
+// The blocking variants spin briefly, then sleep until the other side makes progress,
+// so an idle stream does not keep its threads busy.
+template<typename T>
+class SpscRing
+{
+public:
+    explicit SpscRing(std::size_t capacity)
+    {
+        std::size_t size{ 1 };
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    auto try_push(T &&value) -> bool
+    {
+        const auto tail{ tail_.load(std::memory_order_relaxed) };
+        if (tail - cachedHead_ > mask_)
+        {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ > mask_)
+            {
+                return false;
+            }
+        }
+
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    auto try_pop(T &value) -> bool
+    {
+        const auto head{ head_.load(std::memory_order_relaxed) };
+        if (head == cachedTail_)
+        {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_)
+            {
+                return false;
+            }
+        }
+
+        value = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Blocking variants, a full ring is what applies backpressure to the producer
+    void push(T &&value)
+    {
+        if (!spin([&]() { return try_push(std::move(value)); }))
+        {
+            std::unique_lock<std::mutex> lock{ mutex_ };
+            producerWaiting_.store(true, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            while (!try_push(std::move(value)))
+            {
+                notFull_.wait(lock);
+            }
+            producerWaiting_.store(false, std::memory_order_relaxed);
+        }
+
+        // Pairs with the fence of a consumer going to sleep, one of them sees the other
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (consumerWaiting_.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+            notEmpty_.notify_one();
+        }
+    }
+
+    void pop(T &value)
+    {
+        if (!spin([&]() { return try_pop(value); }))
+        {
+            std::unique_lock<std::mutex> lock{ mutex_ };
+            consumerWaiting_.store(true, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            while (!try_pop(value))
+            {
+                notEmpty_.wait(lock);
+            }
+            consumerWaiting_.store(false, std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (producerWaiting_.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+            notFull_.notify_one();
+        }
+    }
+
+private:
+    // Tries before sleeping, enough to ride out the other thread being briefly descheduled
+    static constexpr int spinTries{ 128 };
+
+    template<typename Try>
+    static auto spin(Try &&attempt) -> bool
+    {
+        for (auto tries{ 0 }; tries < spinTries; ++tries)
+        {
+            if (attempt())
+            {
+                return true;
+            }
+            std::this_thread::yield();
+        }
+
+        return false;
+    }
+
+    alignas(cacheLineSize) std::atomic<std::size_t> head_{ 0 };
+    std::size_t cachedTail_{ 0 };
+
+    alignas(cacheLineSize) std::atomic<std::size_t> tail_{ 0 };
+    std::size_t cachedHead_{ 0 };
+
+    alignas(cacheLineSize) std::vector<T> slots_{};
+    std::size_t mask_{ 0 };
+
+    // Only taken by a side going to sleep and by the side waking it
+    alignas(cacheLineSize) std::atomic<bool> producerWaiting_{ false };
+    std::atomic<bool> consumerWaiting_{ false };
+    std::mutex mutex_{};
+    std::condition_variable notFull_{};
+    std::condition_variable notEmpty_{};
+};
+
+} // namespace mybank
+
+#endif // PROCESS_OPERATIONS_SPSC_RING_H
@@ -0,0 +1,86 @@
+#include <algorithm>
+
+#include "time_buckets.h"
+
+namespace
+{
+
+auto ring_size(std::size_t bucketCount) -> std::size_t
+{
+    std::size_t size{ 1 };
+    while (size < bucketCount)
+    {
+        size <<= 1;
+    }
+    return size;
+}
+
+} // namespace
+
+mybank::TimeBuckets::TimeBuckets(time_t resolutionMillis, std::size_t bucketCount)
+        : resolution_{ std::max<time_t>(resolutionMillis, 1) },
+          counts_(ring_size(bucketCount), 0),
+          mask_{ counts_.size() - 1 }
+{
+}
+
+void mybank::TimeBuckets::add(time_t timeInMillis)
+{
+    const auto bucket{ bucket_of(timeInMillis) };
+
+    if (empty_)
+    {
+        empty_ = false;
+        newestBucket_ = bucket;
+    }
+    else if (bucket > newestBucket_)
+    {
+        // Buckets reused for the new times are cleared, all of them past a whole ring
+        const auto advance{ bucket - newestBucket_ };
+        if (static_cast<std::size_t>(advance) >= counts_.size())
+        {
+            std::fill(counts_.begin(), counts_.end(), 0);
+        }
+        else
+        {
+            for (auto cleared{ newestBucket_ + 1 }; cleared <= bucket; ++cleared)
+            {
+                counts_[static_cast<std::size_t>(cleared) & mask_] = 0;
+            }
+        }
+        newestBucket_ = bucket;
+    }
+    else if (!covers(bucket))
+    {
+        return;
+    }
+
+    ++counts_[static_cast<std::size_t>(bucket) & mask_];
+}
+
+auto mybank::TimeBuckets::bucket_of(time_t timeInMillis) const -> time_t
+{
+    // Rounded down for times before the epoch too
+    const auto bucket{ timeInMillis / resolution_ };
+    return (timeInMillis % resolution_ < 0) ? bucket - 1 : bucket;
+}
+
+auto mybank::TimeBuckets::bucket_start(time_t bucket) const -> time_t
+{
+    return bucket*resolution_;
+}
+
+auto mybank::TimeBuckets::covers(time_t bucket) const -> bool
+{
+    return empty_ || bucket > newestBucket_ - static_cast<time_t>(counts_.size());
+}
+
+auto mybank::TimeBuckets::count(time_t bucket) const -> std::size_t
+{
+    if (empty_ || bucket > newestBucket_)
+    {
+        return 0;
+    }
+
+    return counts_[static_cast<std::size_t>(bucket) & mask_];
+}
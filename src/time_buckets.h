@@ -0,0 +1,41 @@
+#ifndef PROCESS_OPERATIONS_TIME_BUCKETS_H
+#define PROCESS_OPERATIONS_TIME_BUCKETS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+
+namespace mybank
+{
+
+// Ring of transaction counts per bucket of resolutionMillis of transaction time, covering
+// at least bucketCount buckets up to the one of the newest time added. Older buckets are
+// dropped as newer times arrive, times older than the ring are not counted.
+class TimeBuckets
+{
+public:
+    TimeBuckets(time_t resolutionMillis, std::size_t bucketCount);
+
+    void add(time_t timeInMillis);
+
+    auto bucket_of(time_t timeInMillis) const -> time_t;
+    auto bucket_start(time_t bucket) const -> time_t;
+
+    // Whether the counts of the bucket and of every later one are kept in the ring
+    auto covers(time_t bucket) const -> bool;
+
+    // Count of a covered bucket, buckets after the newest one are empty
+    auto count(time_t bucket) const -> std::size_t;
+
+private:
+    time_t resolution_;
+    std::vector<uint32_t> counts_;
+    std::size_t mask_;
+    bool empty_{ true };
+    time_t newestBucket_{ 0 };
+};
+
+} // namespace mybank
+
+#endif // PROCESS_OPERATIONS_TIME_BUCKETS_H
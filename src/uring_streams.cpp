@@ -0,0 +1,517 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "process_operations/uring_streams.h"
+#include "io_uring.h"
+
+namespace
+{
+
+enum class SlotState
+{
+    FREE,
+    IN_FLIGHT,
+    READY
+};
+
+struct io_slot
+{
+    SlotState state;
+    off_t offset;
+    std::size_t size;
+    std::size_t done;
+};
+
+constexpr auto currentPosition{ static_cast<uint64_t>(-1) };
+
+auto is_regular_file(int fd) -> bool
+{
+    struct stat status{};
+    return ::fstat(fd, &status) == 0 && S_ISREG(status.st_mode);
+}
+
+auto is_retryable(int result) -> bool
+{
+    return result == -EINTR || result == -EAGAIN;
+}
+
+// Shared setup of the buffers, registered with the ring when the memory lock limit allows it and the
+// kernel supports the fixed buffer operation. Without either operation the ring is dropped for the fallback.
+struct ring_buffers
+{
+    std::vector<char> storage;
+    std::optional<mybank::IoUring> ring;
+    bool registered;
+    uint8_t opcode;
+
+    ring_buffers(const mybank::uring_options &options, uint8_t fixedOpcode, uint8_t plainOpcode)
+            : storage(std::max(options.queueDepth, 1u)*std::max<std::size_t>(options.bufferSize, 1)),
+              ring{ mybank::IoUring::create(std::max(options.queueDepth, 1u)) },
+              registered{ false },
+              opcode{ plainOpcode }
+    {
+        if (ring.has_value() && ring->supports(fixedOpcode))
+        {
+            std::vector<iovec> buffers(std::max(options.queueDepth, 1u));
+            for (std::size_t i{ 0 }; i < buffers.size(); ++i)
+            {
+                buffers[i].iov_base = storage.data() + i*(storage.size() / buffers.size());
+                buffers[i].iov_len = storage.size() / buffers.size();
+            }
+            registered = ring->register_buffers(buffers.data(), static_cast<unsigned>(buffers.size()));
+        }
+
+        if (registered)
+        {
+            opcode = fixedOpcode;
+        }
+        else if (ring.has_value() && !ring->supports(plainOpcode))
+        {
+            ring.reset();
+        }
+    }
+};
+
+} // namespace
+
+struct mybank::UringInputStreambuf::impl
+{
+    int fd;
+    unsigned depth;
+    std::size_t bufferSize;
+    ring_buffers buffers;
+    bool seekable;
+
+    std::vector<io_slot> slots;
+    off_t nextOffset{ 0 };
+    unsigned nextToSubmit{ 0 };
+    unsigned nextToConsume{ 0 };
+    unsigned inFlight{ 0 };
+    bool consuming{ false };
+    bool endOfInput{ false };
+    bool failed{ false };
+
+    impl(int inputFd, const uring_options &options)
+            : fd{ inputFd },
+              depth{ std::max(options.queueDepth, 1u) },
+              bufferSize{ std::max<std::size_t>(options.bufferSize, 1) },
+              buffers{ options, IORING_OP_READ_FIXED, IORING_OP_READ },
+              seekable{ is_regular_file(inputFd) },
+              slots(depth, io_slot{ SlotState::FREE, 0, 0, 0 })
+    {
+        if (seekable)
+        {
+            nextOffset = ::lseek(fd, 0, SEEK_CUR);
+            seekable = nextOffset >= 0;
+        }
+    }
+
+    ~impl()
+    {
+        // The kernel may still write into the buffers
+        for (io_uring_cqe cqe{}; inFlight > 0 && buffers.ring->next_cqe(cqe, true);)
+        {
+            --inFlight;
+        }
+    }
+
+    auto buffer(unsigned index) -> char *
+    {
+        return buffers.storage.data() + index*bufferSize;
+    }
+
+    void submit_read(unsigned index)
+    {
+        auto &slot{ slots[index] };
+        auto *sqe{ buffers.ring->get_sqe() };
+
+        sqe->opcode = buffers.opcode;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<uintptr_t>(buffer(index) + slot.done);
+        sqe->len = static_cast<uint32_t>(bufferSize - slot.done);
+        sqe->off = seekable ? static_cast<uint64_t>(slot.offset) + slot.done : currentPosition;
+        sqe->buf_index = static_cast<uint16_t>(index);
+        sqe->user_data = index;
+
+        slot.state = SlotState::IN_FLIGHT;
+        ++inFlight;
+    }
+
+    // Regular files keep every free buffer reading ahead, streams only one read at a time to keep the order
+    void submit_reads()
+    {
+        while (!endOfInput && slots[nextToSubmit].state == SlotState::FREE && (seekable || inFlight == 0))
+        {
+            auto &slot{ slots[nextToSubmit] };
+            slot.offset = nextOffset;
+            slot.done = 0;
+            nextOffset += static_cast<off_t>(bufferSize);
+
+            submit_read(nextToSubmit);
+            nextToSubmit = (nextToSubmit + 1) % depth;
+        }
+
+        if (!buffers.ring->submit())
+        {
+            endOfInput = true;
+            failed = true;
+        }
+    }
+
+    void complete(const io_uring_cqe &cqe)
+    {
+        const auto index{ static_cast<unsigned>(cqe.user_data) };
+        auto &slot{ slots[index] };
+        --inFlight;
+
+        if (is_retryable(cqe.res))
+        {
+            submit_read(index);
+            return;
+        }
+
+        // Errors end the input too, recorded so the stream is not taken as read to its end
+        if (cqe.res <= 0)
+        {
+            endOfInput = true;
+            failed = failed || cqe.res < 0;
+            slot.state = SlotState::READY;
+            return;
+        }
+
+        slot.done += static_cast<std::size_t>(cqe.res);
+        if (seekable && slot.done < bufferSize)
+        {
+            submit_read(index);
+            return;
+        }
+
+        slot.state = SlotState::READY;
+    }
+
+    // Fills the next buffer in order, returns the number of bytes available in it
+    auto next_buffer() -> std::size_t
+    {
+        if (consuming)
+        {
+            slots[nextToConsume].state = SlotState::FREE;
+            nextToConsume = (nextToConsume + 1) % depth;
+            consuming = false;
+        }
+
+        submit_reads();
+
+        while (slots[nextToConsume].state != SlotState::READY)
+        {
+            io_uring_cqe cqe{};
+            if (inFlight == 0 || !buffers.ring->next_cqe(cqe, true))
+            {
+                failed = failed || inFlight > 0;
+                return 0;
+            }
+
+            complete(cqe);
+            submit_reads();
+        }
+
+        consuming = true;
+        return slots[nextToConsume].done;
+    }
+
+    auto read_fallback() -> std::size_t
+    {
+        for (;;)
+        {
+            const auto received{ ::read(fd, buffers.storage.data(), bufferSize) };
+            if (received >= 0 || errno != EINTR)
+            {
+                failed = failed || received < 0;
+                return received > 0 ? static_cast<std::size_t>(received) : 0;
+            }
+        }
+    }
+};
+
+mybank::UringInputStreambuf::UringInputStreambuf(int fd, const uring_options &options)
+        : impl_{ std::make_unique<impl>(fd, options) }
+{
+}
+
+mybank::UringInputStreambuf::~UringInputStreambuf() = default;
+
+auto mybank::UringInputStreambuf::uses_io_uring() const -> bool
+{
+    return impl_->buffers.ring.has_value();
+}
+
+auto mybank::UringInputStreambuf::failed() const -> bool
+{
+    return impl_->failed;
+}
+
+auto mybank::UringInputStreambuf::underflow() -> int_type
+{
+    if (gptr() < egptr())
+    {
+        return traits_type::to_int_type(*gptr());
+    }
+
+    const auto available{ uses_io_uring() ? impl_->next_buffer() : impl_->read_fallback() };
+    if (available == 0)
+    {
+        return traits_type::eof();
+    }
+
+    auto *begin{ uses_io_uring() ? impl_->buffer(impl_->nextToConsume) : impl_->buffers.storage.data() };
+    setg(begin, begin, begin + available);
+    return traits_type::to_int_type(*gptr());
+}
+
+struct mybank::UringOutputStreambuf::impl
+{
+    int fd;
+    unsigned depth;
+    std::size_t bufferSize;
+    ring_buffers buffers;
+    bool seekable;
+
+    std::vector<io_slot> slots;
+    off_t nextOffset{ 0 };
+    unsigned active{ 0 };
+    unsigned inFlight{ 0 };
+    bool failed{ false };
+
+    impl(int outputFd, const uring_options &options)
+            : fd{ outputFd },
+              depth{ std::max(options.queueDepth, 1u) },
+              bufferSize{ std::max<std::size_t>(options.bufferSize, 1) },
+              buffers{ options, IORING_OP_WRITE_FIXED, IORING_OP_WRITE },
+              seekable{ is_regular_file(outputFd) && (::fcntl(outputFd, F_GETFL) & O_APPEND) == 0 },
+              slots(depth, io_slot{ SlotState::FREE, 0, 0, 0 })
+    {
+        if (seekable)
+        {
+            nextOffset = ::lseek(fd, 0, SEEK_CUR);
+            seekable = nextOffset >= 0;
+        }
+    }
+
+    auto buffer(unsigned index) -> char *
+    {
+        return buffers.storage.data() + index*bufferSize;
+    }
+
+    void submit_write(unsigned index)
+    {
+        auto &slot{ slots[index] };
+        auto *sqe{ buffers.ring->get_sqe() };
+
+        sqe->opcode = buffers.opcode;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<uintptr_t>(buffer(index) + slot.done);
+        sqe->len = static_cast<uint32_t>(slot.size - slot.done);
+        sqe->off = seekable ? static_cast<uint64_t>(slot.offset) + slot.done : currentPosition;
+        sqe->buf_index = static_cast<uint16_t>(index);
+        sqe->user_data = index;
+
+        slot.state = SlotState::IN_FLIGHT;
+        ++inFlight;
+    }
+
+    void complete(const io_uring_cqe &cqe)
+    {
+        const auto index{ static_cast<unsigned>(cqe.user_data) };
+        auto &slot{ slots[index] };
+        --inFlight;
+
+        if (is_retryable(cqe.res))
+        {
+            submit_write(index);
+            return;
+        }
+
+        if (cqe.res <= 0)
+        {
+            failed = true;
+            slot.state = SlotState::FREE;
+            return;
+        }
+
+        slot.done += static_cast<std::size_t>(cqe.res);
+        if (slot.done < slot.size)
+        {
+            submit_write(index);
+            return;
+        }
+
+        slot.state = SlotState::FREE;
+    }
+
+    void wait_one()
+    {
+        io_uring_cqe cqe{};
+        if (!buffers.ring->next_cqe(cqe, true))
+        {
+            failed = true;
+            inFlight = 0;
+            return;
+        }
+
+        complete(cqe);
+        failed = !buffers.ring->submit() || failed;
+    }
+
+    // Hands the filled part of the active buffer to the kernel and moves on to the next free buffer
+    void submit_active(std::size_t size)
+    {
+        if (size == 0)
+        {
+            return;
+        }
+
+        // Writes that do not target an explicit offset must not overlap to keep their order
+        while (!seekable && inFlight > 0)
+        {
+            wait_one();
+        }
+
+        auto &slot{ slots[active] };
+        slot.offset = nextOffset;
+        slot.size = size;
+        slot.done = 0;
+        nextOffset += static_cast<off_t>(size);
+
+        submit_write(active);
+        failed = !buffers.ring->submit() || failed;
+
+        active = (active + 1) % depth;
+        while (slots[active].state != SlotState::FREE && inFlight > 0)
+        {
+            wait_one();
+        }
+    }
+
+    void drain()
+    {
+        while (inFlight > 0)
+        {
+            wait_one();
+        }
+
+        if (seekable)
+        {
+            ::lseek(fd, nextOffset, SEEK_SET);
+        }
+    }
+
+    void write_fallback(std::size_t size)
+    {
+        const auto *data{ buffers.storage.data() };
+        while (size > 0)
+        {
+            const auto written{ ::write(fd, data, size) };
+            if (written < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (written <= 0)
+            {
+                failed = true;
+                return;
+            }
+
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+    }
+};
+
+mybank::UringOutputStreambuf::UringOutputStreambuf(int fd, const uring_options &options)
+        : impl_{ std::make_unique<impl>(fd, options) }
+{
+    setp(impl_->buffer(0), impl_->buffer(0) + impl_->bufferSize);
+}
+
+mybank::UringOutputStreambuf::~UringOutputStreambuf()
+{
+    sync();
+}
+
+auto mybank::UringOutputStreambuf::uses_io_uring() const -> bool
+{
+    return impl_->buffers.ring.has_value();
+}
+
+auto mybank::UringOutputStreambuf::overflow(int_type c) -> int_type
+{
+    const auto size{ static_cast<std::size_t>(pptr() - pbase()) };
+    if (uses_io_uring())
+    {
+        impl_->submit_active(size);
+    }
+    else
+    {
+        impl_->write_fallback(size);
+    }
+
+    setp(impl_->buffer(impl_->active), impl_->buffer(impl_->active) + impl_->bufferSize);
+
+    if (impl_->failed)
+    {
+        return traits_type::eof();
+    }
+
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+
+    return traits_type::not_eof(c);
+}
+
+auto mybank::UringOutputStreambuf::sync() -> int
+{
+    overflow(traits_type::eof());
+
+    if (uses_io_uring())
+    {
+        impl_->drain();
+    }
+
+    return impl_->failed ? -1 : 0;
+}
+
+auto mybank::process_operations(
+        int inputFd,
+        int outputFd,
+        const process_options &options,
+        const uring_options &uringOptions)
+        -> bool
+{
+    mybank::UringInputStreambuf inputBuffer{ inputFd, uringOptions };
+    mybank::UringOutputStreambuf outputBuffer{ outputFd, uringOptions };
+
+    std::istream in{ &inputBuffer };
+    std::ostream out{ &outputBuffer };
+
+    process_operations(in, out, options);
+    out.flush();
+
+    // The stream buffer can only report the end of the input, a read error is set on the stream here
+    if (inputBuffer.failed())
+    {
+        in.setstate(std::ios::badbit);
+    }
+
+    return !in.bad() && !out.bad();
+}
@@ -3,18 +3,62 @@
 
 namespace mybank {
 
+struct decoded_operation;
+struct operation_view;
+struct transaction_view;
+
+// Violations as bits, converting back yields them in the order the validations report them
+using violation_mask = uint8_t;
+
+auto to_violation_mask(const std::vector<Violation> &) -> violation_mask;
+auto to_violations(violation_mask) -> std::vector<Violation>;
+
+// Counts a decoded line, or a skipped one when empty, in the metrics when they are set
+void record_decoded_line(const std::optional<decoded_operation> &, const process_options &);
+void record_decoded_line(const operation_view *, const process_options &);
+
+void authorize_operation(
+        account &,
+        transaction_history &,
+        history_index &,
+        const operation_view &,
+        std::vector<Violation> &,
+        const process_options &);
+
+// Runs every validation and, when there are no violations,
+// debits the account and admits the transaction into the history
+void authorize_transaction(
+        account &,
+        transaction_history &,
+        history_index &,
+        const transaction_view &,
+        std::vector<Violation> &,
+        const process_options &);
+
 void validate_active_account(
         const account &,
         std::vector<Violation> &);
 
 void validate_sufficient_limit(
         const account &,
-        const transaction &,
+        const transaction_view &,
+        std::vector<Violation> &);
+
+void validate_spend_velocity(
+        const mybank::transaction_history &,
+        const history_index &,
+        const transaction_view &,
         std::vector<Violation> &);
 
 void validate_transactions_small_interval(
-        const std::map<time_t, mybank::transaction> &,
-        const transaction &,
+        const mybank::transaction_history &,
+        const history_index &,
+        const transaction_view &,
+        std::vector<Violation> &);
+
+void validate_velocity_rules(
+        const history_index &,
+        const transaction_view &,
         std::vector<Violation> &);
 
 } //namespace mybank
@@ -0,0 +1,469 @@
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "process_operations/write_ahead_log.h"
+#include "json_utils.h"
+
+namespace
+{
+
+// Bytes written before the first error, all of them when it succeeds
+auto write_all(int fd, std::string_view buffer) -> std::size_t
+{
+    std::size_t total{ 0 };
+
+    while (total < buffer.size())
+    {
+        const auto written{ ::write(fd, buffer.data() + total, buffer.size() - total) };
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+
+        total += static_cast<std::size_t>(written);
+    }
+
+    return total;
+}
+
+// Makes the creation or renaming of the file durable, the directory entry is only synced with its directory
+auto sync_directory(const std::string &path) -> bool
+{
+    auto directory{ std::filesystem::path{ path }.parent_path() };
+    if (directory.empty())
+    {
+        directory = ".";
+    }
+
+    const auto fd{ ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC) };
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    const auto synced{ ::fsync(fd) == 0 };
+    ::close(fd);
+    return synced;
+}
+
+// Reads backwards from the end of the log to its last newline, returning the offset past it
+// (0 when there is none) and the complete record it ends
+auto find_last_record(int fd, off_t size, std::string &record) -> std::optional<off_t>
+{
+    constexpr off_t chunkSize{ 4096 };
+
+    std::string tail{};
+    auto position{ size };
+    while (position > 0)
+    {
+        const auto length{ std::min(chunkSize, position) };
+        std::string chunk(static_cast<std::size_t>(length), '\0');
+        if (::pread(fd, chunk.data(), chunk.size(), position - length) != length)
+        {
+            return std::nullopt;
+        }
+        tail.insert(0, chunk);
+        position -= length;
+
+        const auto lastNewline{ tail.rfind('\n') };
+        if (lastNewline == std::string::npos)
+        {
+            continue;
+        }
+
+        const auto previousNewline{ (lastNewline == 0) ? std::string::npos : tail.rfind('\n', lastNewline - 1) };
+        if (previousNewline != std::string::npos || position == 0)
+        {
+            const auto recordStart{ (previousNewline == std::string::npos) ? 0 : previousNewline + 1 };
+            record = tail.substr(recordStart, lastNewline - recordStart);
+            return position + static_cast<off_t>(lastNewline) + 1;
+        }
+    }
+
+    record.clear();
+    return 0;
+}
+
+// Cuts a record torn by a crash off the end of the log, so the next one starts on its own line.
+// Returns the sequence of the last complete record, 0 when there is none or the log is not a regular file.
+auto truncate_torn_record(int fd) -> std::optional<uint64_t>
+{
+    struct stat status{};
+    if (::fstat(fd, &status) != 0)
+    {
+        return std::nullopt;
+    }
+    if (!S_ISREG(status.st_mode))
+    {
+        return 0;
+    }
+
+    std::string record{};
+    const auto end{ find_last_record(fd, status.st_size, record) };
+    if (!end.has_value())
+    {
+        return std::nullopt;
+    }
+
+    if (end.value() != status.st_size && (::ftruncate(fd, end.value()) != 0 || ::fdatasync(fd) != 0))
+    {
+        return std::nullopt;
+    }
+
+    const auto recordJson = json::parse(record, nullptr, false);
+    if (recordJson.is_object() && recordJson.contains("seq") && recordJson["seq"].is_number_unsigned())
+    {
+        return recordJson["seq"].get<uint64_t>();
+    }
+
+    return 0;
+}
+
+} // namespace
+
+struct mybank::WriteAheadLog::impl
+{
+    impl(int fd, const wal_options &options, uint64_t lastSequence);
+    impl(const impl &) = delete;
+    impl &operator=(const impl &) = delete;
+    ~impl();
+
+    // Called without the mutex held, the pending records are taken from the buffer under it and then
+    // written and synced without it, so appending does not wait for the disk. What was written is dropped
+    // even when the commit fails, so a retry continues the partly written record instead of repeating it.
+    auto commit_pending() -> bool;
+
+    // Body of the flusher thread, committing the groups whose interval expires while no records arrive
+    void flush_when_due();
+
+    int fd;
+    wal_options options;
+    uint64_t sequence;
+
+    // Taken before the mutex by commits, keeping the groups in order while they are written
+    std::mutex commitMutex{};
+    std::mutex mutex{};
+    std::condition_variable recordPending{};
+    bool stopping{ false };
+    std::size_t pendingRecords{ 0 };
+    std::string pendingBuffer{};
+    std::chrono::steady_clock::time_point oldestPending{};
+    std::thread flusher{};
+};
+
+mybank::WriteAheadLog::impl::impl(int fd, const wal_options &options, uint64_t lastSequence)
+        : fd{ fd },
+          options{ options },
+          sequence{ lastSequence }
+{
+    // Otherwise every record is committed as it is appended
+    if (options.groupCommitRecords > 1 && options.groupCommitInterval.count() > 0)
+    {
+        flusher = std::thread{ [this]() { flush_when_due(); } };
+    }
+}
+
+mybank::WriteAheadLog::impl::~impl()
+{
+    {
+        std::lock_guard<std::mutex> lock{ mutex };
+        stopping = true;
+    }
+    recordPending.notify_one();
+
+    if (flusher.joinable())
+    {
+        flusher.join();
+    }
+
+    commit_pending();
+    ::close(fd);
+}
+
+auto mybank::WriteAheadLog::impl::commit_pending() -> bool
+{
+    std::lock_guard<std::mutex> commitLock{ commitMutex };
+
+    std::string group{};
+    std::size_t groupRecords;
+    {
+        std::lock_guard<std::mutex> lock{ mutex };
+        if (pendingRecords == 0)
+        {
+            return true;
+        }
+
+        group.swap(pendingBuffer);
+        groupRecords = std::exchange(pendingRecords, 0);
+    }
+
+    group.erase(0, write_all(fd, group));
+    if (group.empty() && ::fdatasync(fd) == 0)
+    {
+        return true;
+    }
+
+    // Back in front of the records appended meanwhile, retried after another interval instead of in a busy loop
+    std::lock_guard<std::mutex> lock{ mutex };
+    pendingBuffer.insert(0, group);
+    pendingRecords += groupRecords;
+    oldestPending = std::chrono::steady_clock::now();
+    return false;
+}
+
+void mybank::WriteAheadLog::impl::flush_when_due()
+{
+    std::unique_lock<std::mutex> lock{ mutex };
+    while (!stopping)
+    {
+        if (pendingRecords == 0)
+        {
+            recordPending.wait(lock);
+            continue;
+        }
+
+        const auto due{ oldestPending + options.groupCommitInterval };
+        if (std::chrono::steady_clock::now() < due)
+        {
+            recordPending.wait_until(lock, due);
+            continue;
+        }
+
+        lock.unlock();
+        commit_pending();
+        lock.lock();
+    }
+}
+
+auto mybank::WriteAheadLog::open(const wal_options &options, uint64_t lastSequence)
+        -> std::optional<WriteAheadLog>
+{
+    const auto fd{ ::open(options.path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644) };
+    if (fd < 0)
+    {
+        return std::nullopt;
+    }
+
+    const auto lastRecord{ truncate_torn_record(fd) };
+    if (!lastRecord.has_value() || !sync_directory(options.path))
+    {
+        ::close(fd);
+        return std::nullopt;
+    }
+
+    // Continues after the last complete record, unless a checkpoint covers more than the log holds
+    const auto sequence{ std::max(lastSequence, lastRecord.value()) };
+    return std::optional<WriteAheadLog>{ WriteAheadLog{ std::make_unique<impl>(fd, options, sequence) } };
+}
+
+mybank::WriteAheadLog::WriteAheadLog(std::unique_ptr<impl> log)
+        : impl_{ std::move(log) }
+{
+}
+
+mybank::WriteAheadLog::WriteAheadLog(WriteAheadLog &&) noexcept = default;
+
+auto mybank::WriteAheadLog::operator=(WriteAheadLog &&) noexcept -> WriteAheadLog & = default;
+
+mybank::WriteAheadLog::~WriteAheadLog() = default;
+
+auto mybank::WriteAheadLog::append(const mybank::account &account) -> bool
+{
+    return append_record("account", json(account).dump());
+}
+
+auto mybank::WriteAheadLog::append(const mybank::transaction &transaction) -> bool
+{
+    return append_record("transaction", json(transaction).dump());
+}
+
+auto mybank::WriteAheadLog::append_record(const char *field, const std::string &value) -> bool
+{
+    if (impl_ == nullptr)
+    {
+        return false;
+    }
+
+    bool due;
+    {
+        std::lock_guard<std::mutex> lock{ impl_->mutex };
+
+        const auto now{ std::chrono::steady_clock::now() };
+        if (impl_->pendingRecords == 0)
+        {
+            impl_->oldestPending = now;
+            impl_->recordPending.notify_one();
+        }
+
+        // Numbered in the order the records are buffered, so concurrent appenders never share a sequence
+        ++impl_->sequence;
+        ++impl_->pendingRecords;
+        auto &buffer{ impl_->pendingBuffer };
+        buffer += "{\"seq\":";
+        buffer += std::to_string(impl_->sequence);
+        buffer += ",\"";
+        buffer += field;
+        buffer += "\":";
+        buffer += value;
+        buffer += "}\n";
+
+        due = impl_->pendingRecords >= impl_->options.groupCommitRecords ||
+              now - impl_->oldestPending >= impl_->options.groupCommitInterval;
+    }
+
+    return !due || impl_->commit_pending();
+}
+
+auto mybank::WriteAheadLog::commit() -> bool
+{
+    if (impl_ == nullptr)
+    {
+        return false;
+    }
+
+    return impl_->commit_pending();
+}
+
+auto mybank::WriteAheadLog::sequence() const -> uint64_t
+{
+    if (impl_ == nullptr)
+    {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock{ impl_->mutex };
+    return impl_->sequence;
+}
+
+auto mybank::write_checkpoint(
+        const std::string &path,
+        const mybank::account &account,
+        const mybank::transaction_history &validTransactions,
+        uint64_t walSequence)
+        -> bool
+{
+    auto transactionsJson{ json::array() };
+    for (const auto &[timeInMillis, transaction] : validTransactions)
+    {
+        transactionsJson.push_back(transaction);
+    }
+
+    const auto checkpointJson = json{
+        { "account", account },
+        { "transactions", transactionsJson },
+        { "walSequence", walSequence }
+    };
+
+    const auto temporaryPath{ path + ".tmp" };
+    const auto fd{ ::open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) };
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    const auto checkpoint{ checkpointJson.dump() };
+    const auto written{ write_all(fd, checkpoint) == checkpoint.size() && ::fsync(fd) == 0 };
+    ::close(fd);
+
+    return written && std::rename(temporaryPath.c_str(), path.c_str()) == 0 && sync_directory(path);
+}
+
+auto mybank::recover_state(const std::string &checkpointPath, const std::string &walPath)
+        -> std::optional<mybank::recovered_state>
+{
+    recovered_state state{ std::nullopt, {}, 0 };
+
+    std::ifstream checkpointFile{ checkpointPath };
+    std::string checkpointContent{
+        std::istreambuf_iterator<char>{ checkpointFile },
+        std::istreambuf_iterator<char>{} };
+
+    const auto checkpointJson = json::parse(checkpointContent, nullptr, false);
+    if (!checkpointJson.is_discarded() &&
+        is_valid_json_account(checkpointJson) &&
+        checkpointJson.contains("walSequence") &&
+        checkpointJson["walSequence"].is_number_unsigned())
+    {
+        state.account = checkpointJson["account"].get<mybank::account>();
+        state.walSequence = checkpointJson["walSequence"].get<uint64_t>();
+
+        for (const auto &transactionJson : checkpointJson.value("transactions", json::array()))
+        {
+            if (is_valid_json_transaction(json{ { "transaction", transactionJson } }))
+            {
+                const auto transaction{ transactionJson.get<mybank::transaction>() };
+                state.validTransactions.emplace(transaction.timeInMillis, transaction);
+            }
+        }
+    }
+
+    std::ifstream walFile{ walPath };
+    for (std::string walLine; std::getline(walFile, walLine);)
+    {
+        // Only the last line can be torn by a crash, it has no newline (open cuts it off before appending)
+        const auto torn{ walFile.eof() };
+
+        const auto walJson = json::parse(walLine, nullptr, false);
+        if (walJson.is_discarded() ||
+            !walJson.is_object() ||
+            !walJson.contains("seq") ||
+            !walJson["seq"].is_number_unsigned())
+        {
+            if (torn)
+            {
+                break;
+            }
+            return std::nullopt;
+        }
+
+        const auto sequence{ walJson["seq"].get<uint64_t>() };
+        if (sequence <= state.walSequence)
+        {
+            continue;
+        }
+
+        // A missing record is an accepted change that cannot be replayed
+        if (sequence != state.walSequence + 1)
+        {
+            return std::nullopt;
+        }
+
+        if (is_valid_json_account(walJson))
+        {
+            if (!state.account.has_value())
+            {
+                state.account = walJson["account"].get<mybank::account>();
+            }
+        }
+        else if (is_valid_json_transaction(walJson) && state.account.has_value())
+        {
+            const auto transaction{ walJson["transaction"].get<mybank::transaction>() };
+            state.account->availableLimit -= transaction.amount;
+            state.validTransactions.emplace(transaction.timeInMillis, transaction);
+        }
+        else
+        {
+            return std::nullopt;
+        }
+
+        state.walSequence = sequence;
+    }
+
+    return state;
+}
@@ -0,0 +1,146 @@
+#define CATCH_CONFIG_MAIN
+
+#include <coroutine>
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "../include/process_operations/async_authorizer.h"
+
+namespace
+{
+
+// Source whose reads stay suspended until the test delivers a line or closes it
+class manual_source
+{
+public:
+    auto next()
+    {
+        struct awaiter
+        {
+            manual_source &source;
+
+            auto await_ready() -> bool { return !source.lines_.empty() || source.closed_; }
+            void await_suspend(std::coroutine_handle<> handle) { source.waiting_ = handle; }
+
+            auto await_resume() -> std::optional<std::string>
+            {
+                if (source.lines_.empty())
+                {
+                    return std::nullopt;
+                }
+
+                auto line{ std::move(source.lines_.front()) };
+                source.lines_.pop_front();
+                return line;
+            }
+        };
+
+        return awaiter{ *this };
+    }
+
+    void deliver(std::string line)
+    {
+        lines_.push_back(std::move(line));
+        resume();
+    }
+
+    void close()
+    {
+        closed_ = true;
+        resume();
+    }
+
+    auto waiting() const -> bool { return static_cast<bool>(waiting_); }
+
+private:
+    void resume()
+    {
+        if (waiting_)
+        {
+            std::exchange(waiting_, {}).resume();
+        }
+    }
+
+    std::deque<std::string> lines_{};
+    bool closed_{ false };
+    std::coroutine_handle<> waiting_{};
+};
+
+struct collecting_sink
+{
+    std::string written{};
+
+    auto write(std::string_view line)
+    {
+        written += line;
+        return std::suspend_never{};
+    }
+};
+
+} // namespace
+
+TEST_CASE( "Test async authorizer streams", "[async_authorizer]" )
+{
+    SECTION( "with a suspended source, then each line is authorized when it is delivered" )
+    {
+        manual_source source{};
+        collecting_sink sink{};
+        mybank::Authorizer authorizer{};
+
+        auto stream{ mybank::authorize_stream(source, sink, authorizer) };
+        stream.start();
+        REQUIRE( source.waiting() );
+
+        source.deliver(R"({"account":{"activeAccount":true,"availableLimit":100}})");
+        REQUIRE( sink.written == "{\"account\":{\"activeAccount\":true,\"availableLimit\":100},\"violations\":[]}\n" );
+
+        source.deliver(R"({"transaction":{"merchant":"Burger King","amount":120,"time":"2019-02-13T10:00:00.000Z"}})");
+        source.deliver("not json");
+        source.deliver(R"({"transaction":{"merchant":"Burger King","amount":20,"time":"2019-02-13T10:00:00.000Z"}})");
+
+        REQUIRE( sink.written ==
+                 "{\"account\":{\"activeAccount\":true,\"availableLimit\":100},\"violations\":[]}\n"
+                 "{\"account\":{\"activeAccount\":true,\"availableLimit\":100},\"violations\":[\"insufficient-limit\"]}\n"
+                 "{\"account\":{\"activeAccount\":true,\"availableLimit\":80},\"violations\":[]}\n" );
+        REQUIRE( authorizer.state().account->availableLimit == 80 );
+        REQUIRE( !stream.done() );
+
+        source.close();
+        REQUIRE( stream.done() );
+    }
+
+    SECTION( "with thousands of streams on one thread, then each keeps its own state" )
+    {
+        constexpr std::size_t streamCount{ 2000 };
+
+        std::vector<manual_source> sources(streamCount);
+        std::vector<collecting_sink> sinks(streamCount);
+        std::vector<mybank::Authorizer> authorizers(streamCount);
+        std::vector<mybank::task> streams{};
+        streams.reserve(streamCount);
+
+        for (std::size_t i{ 0 }; i < streamCount; ++i)
+        {
+            streams.push_back(mybank::authorize_stream(sources[i], sinks[i], authorizers[i]));
+            streams.back().start();
+            sources[i].deliver(R"({"account":{"activeAccount":true,"availableLimit":)" + std::to_string(i) + "}}");
+        }
+
+        for (std::size_t i{ 0 }; i < streamCount; i += 2)
+        {
+            sources[i].deliver(R"({"transaction":{"merchant":"Burger King","amount":1,"time":"2019-02-13T10:00:00.000Z"}})");
+        }
+
+        for (std::size_t i{ 0 }; i < streamCount; ++i)
+        {
+            sources[i].close();
+            REQUIRE( streams[i].done() );
+            REQUIRE( authorizers[i].state().account->availableLimit == static_cast<int64_t>((i % 2 == 0 && i > 0) ? i - 1 : i) );
+        }
+    }
+}
@@ -0,0 +1,94 @@
+#include <iterator>
+#include <sstream>
+#include <string>
+
+#include "catch.hpp"
+
+#include "../include/process_operations/process_operations.h"
+#include "generate_operations.h"
+
+TEST_CASE( "Test Authorizer", "[authorizer]" )
+{
+    SECTION( "with lines fed one at a time, then the output is the same as process_operations" )
+    {
+        const auto inputOperations{ mybank::test::generate_operations(2000) };
+
+        std::istringstream input{ inputOperations };
+        std::ostringstream output;
+        mybank::process_operations(input, output);
+
+        mybank::Authorizer authorizer{};
+        std::string authorizerOutput{};
+        std::istringstream lines{ inputOperations };
+        for (std::string inputLine; std::getline(lines, inputLine);)
+        {
+            authorizerOutput += authorizer.process(inputLine);
+        }
+
+        REQUIRE( authorizerOutput == output.str() );
+    }
+
+    SECTION( "with lines before the account, then they produce no output" )
+    {
+        mybank::Authorizer authorizer{};
+
+        REQUIRE( authorizer.process(R"({"transaction":{"merchant":"Burger King","amount":20,"time":"2019-02-13T10:00:00.000Z"}})").empty() );
+        REQUIRE( authorizer.process("not json").empty() );
+        REQUIRE( !authorizer.state().account.has_value() );
+
+        REQUIRE( authorizer.process(R"({"account":{"activeAccount":true,"availableLimit":100}})") ==
+                 "{\"account\":{\"activeAccount\":true,\"availableLimit\":100},\"violations\":[]}\n" );
+        REQUIRE( authorizer.process(R"({"account":{"activeAccount":true,"availableLimit":350}})") ==
+                 "{\"account\":{\"activeAccount\":true,\"availableLimit\":100},\"violations\":[\"account-already-initialized\"]}\n" );
+    }
+
+    SECTION( "with decoded transactions, then the state is updated and inspectable" )
+    {
+        mybank::Authorizer authorizer{};
+        const mybank::transaction transaction{ 20, "Burger King", "2019-02-13T10:00:00.000Z", 1550052000000 };
+
+        REQUIRE( authorizer.process(transaction).empty() );
+        REQUIRE( authorizer.state().validTransactions.empty() );
+
+        authorizer.process(R"({"account":{"activeAccount":true,"availableLimit":30}})");
+
+        REQUIRE( authorizer.process(transaction).empty() );
+        REQUIRE( authorizer.process(transaction) == std::vector<mybank::Violation>{ mybank::Violation::INSUFFICIENT_LIMIT } );
+        REQUIRE( authorizer.state().account->availableLimit == 10 );
+        REQUIRE( authorizer.state().validTransactions.size() == 1 );
+    }
+
+    SECTION( "with a stream after single lines, then processing continues from the same state" )
+    {
+        mybank::Authorizer authorizer{};
+        authorizer.process(R"({"account":{"activeAccount":true,"availableLimit":100}})");
+
+        std::istringstream input{ R"({"transaction":{"merchant":"Burger King","amount":20,"time":"2019-02-13T10:00:00.000Z"}})" "\n" };
+        std::ostringstream output;
+        authorizer.process(input, output);
+
+        REQUIRE( output.str() == "{\"account\":{\"activeAccount\":true,\"availableLimit\":80},\"violations\":[]}\n" );
+        REQUIRE( authorizer.state().account->availableLimit == 80 );
+    }
+
+    SECTION( "with lines decoded from a reused buffer, then the history outlives the lines" )
+    {
+        mybank::Authorizer authorizer{};
+        authorizer.process(R"({"account":{"activeAccount":true,"availableLimit":100}})");
+
+        // Transactions are decoded into views of the line, so the admitted ones must own their strings
+        std::string inputLine{ R"({"transaction":{"merchant":"Burger King","amount":20,"time":"2019-02-13T10:00:00.000Z"}})" };
+        authorizer.process(inputLine);
+        inputLine = R"({"transaction":{"merchant":"Esc\"aped","amount":5,"time":"2019-02-13T10:00:10.000Z"}})";
+        authorizer.process(inputLine);
+        inputLine = R"({"transaction":{"merchant":"Burger King","amount":20,"time":"2019-02-13T10:01:00.000Z"}})";
+        authorizer.process(inputLine);
+
+        REQUIRE( authorizer.state().validTransactions.begin()->second.merchant == "Burger King" );
+        REQUIRE( std::next(authorizer.state().validTransactions.begin())->second.merchant == "Esc\"aped" );
+
+        inputLine = R"({"transaction":{"merchant":"Burger King","amount":20,"time":"2019-02-13T10:01:30.000Z"}})";
+        REQUIRE( authorizer.process(inputLine) ==
+                 "{\"account\":{\"activeAccount\":true,\"availableLimit\":55},\"violations\":[\"doubled-transaction\",\"high-frequency-small-interval\"]}\n" );
+    }
+}
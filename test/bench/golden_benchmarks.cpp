@@ -0,0 +1,486 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "../../include/process_operations/process_operations.h"
+#include "../../src/json_utils.h"
+#include "../../src/output_renderer.h"
+#include "perf_counters.h"
+
+using json = nlohmann::json;
+
+namespace
+{
+
+std::atomic<unsigned long long> allocations{ 0 };
+
+const char *const corpusNames[]{ "in_order", "shuffled", "burst_heavy", "mostly_invalid", "multi_merchant" };
+
+struct benchmark_options
+{
+    std::string corpusDirectory{ "corpus" };
+    std::string baselinePath{};
+    std::string outputPath{};
+    double tolerance{ 0.2 };
+    double minSeconds{ 0.5 };
+    bool record{ false };
+    bool allocationsOnly{ false };
+    bool perfCounters{ false };
+    mybank::HugePages hugePages{ mybank::HugePages::OFF };
+};
+
+struct stage_result
+{
+    const char *name;
+    double nanoseconds{ 0 };
+    mybank::test::perf_counts counts{};
+};
+
+struct corpus_result
+{
+    std::size_t operations{ 0 };
+    double operationsPerSecond{ 0 };
+    double allocationsPerOperation{ 0 };
+    std::vector<stage_result> stages{};
+};
+
+auto read_file(const std::filesystem::path &path) -> std::string
+{
+    std::ifstream file{ path, std::ios::binary };
+    return std::string{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+}
+
+auto run_once(const std::string &inputOperations) -> std::chrono::duration<double>
+{
+    std::istringstream input{ inputOperations };
+    std::ostringstream output;
+
+    const auto start{ std::chrono::steady_clock::now() };
+    mybank::process_operations(input, output);
+    return std::chrono::steady_clock::now() - start;
+}
+
+auto split_lines(const std::string &inputOperations) -> std::vector<std::string_view>
+{
+    std::vector<std::string_view> lines{};
+    std::string_view remaining{ inputOperations };
+    while (!remaining.empty())
+    {
+        const auto end{ std::min(remaining.find('\n'), remaining.size()) };
+        lines.push_back(remaining.substr(0, end));
+        remaining.remove_prefix(std::min(end + 1, remaining.size()));
+    }
+
+    return lines;
+}
+
+template<typename Stage>
+auto measure_stage(const char *name, mybank::test::PerfCounters &counters, Stage &&stage) -> stage_result
+{
+    stage_result result{ name };
+
+    counters.start();
+    const auto start{ std::chrono::steady_clock::now() };
+    stage();
+    const auto elapsed{ std::chrono::steady_clock::now() - start };
+    result.counts = counters.stop();
+
+    result.nanoseconds = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    return result;
+}
+
+// Operations after the first account only go through the rules when they are transactions
+void authorize_operations(
+        const std::vector<std::optional<mybank::decoded_operation>> &operations,
+        const mybank::process_options &options)
+{
+    mybank::Authorizer authorizer{ options };
+    for (const auto &operation : operations)
+    {
+        if (!operation.has_value())
+        {
+            continue;
+        }
+
+        if (!authorizer.state().account.has_value())
+        {
+            if (operation->type == mybank::OperationType::ACCOUNT)
+            {
+                authorizer.restore(operation->account, {});
+            }
+        }
+        else if (operation->type == mybank::OperationType::TRANSACTION)
+        {
+            authorizer.process(operation->transaction);
+        }
+    }
+}
+
+// Decoding, authorizing and rendering measured apart, then the whole stream again for reference.
+// With huge pages, authorizing and the whole stream are measured again with the history in huge pages.
+auto measure_stages(
+        const std::string &inputOperations,
+        const benchmark_options &options,
+        mybank::test::PerfCounters &counters)
+        -> std::vector<stage_result>
+{
+    const auto lines{ split_lines(inputOperations) };
+    std::vector<std::optional<mybank::decoded_operation>> operations{};
+    operations.reserve(lines.size());
+
+    // Accounts and violations to render, collected outside of the measured stages
+    std::vector<std::pair<mybank::account, std::vector<mybank::Violation>>> outputs{};
+    {
+        mybank::Authorizer authorizer{};
+        for (const auto line : lines)
+        {
+            const auto output{ authorizer.process(line) };
+            if (!output.empty())
+            {
+                outputs.emplace_back(authorizer.state().account.value(), authorizer.state().violations);
+            }
+        }
+    }
+
+    std::vector<stage_result> stages{};
+
+    // Decoded into views like the sequential path does, then again into owning operations to authorize
+    mybank::OperationDecoder decoder{};
+    std::size_t decodedLines{ 0 };
+    stages.push_back(measure_stage("decode", counters, [&] {
+        for (const auto line : lines)
+        {
+            decodedLines += (decoder.decode(line) != nullptr) ? 1 : 0;
+        }
+    }));
+
+    for (const auto line : lines)
+    {
+        operations.push_back(mybank::decode_operation(line));
+    }
+
+    stages.push_back(measure_stage("authorize", counters, [&] {
+        authorize_operations(operations, {});
+    }));
+
+    mybank::process_options hugePagesOptions{};
+    hugePagesOptions.hugePages = options.hugePages;
+    if (options.hugePages != mybank::HugePages::OFF)
+    {
+        stages.push_back(measure_stage("authorizeHugePages", counters, [&] {
+            authorize_operations(operations, hugePagesOptions);
+        }));
+    }
+
+    std::string rendered{};
+    mybank::OutputRenderer renderer{ false };
+    stages.push_back(measure_stage("render", counters, [&] {
+        for (const auto &[account, violations] : outputs)
+        {
+            renderer.append(rendered, 0, mybank::OperationType::TRANSACTION, account, violations);
+        }
+    }));
+
+    std::istringstream input{ inputOperations };
+    std::ostringstream output;
+    stages.push_back(measure_stage("endToEnd", counters, [&] {
+        mybank::process_operations(input, output);
+    }));
+
+    if (options.hugePages != mybank::HugePages::OFF)
+    {
+        std::istringstream hugePagesInput{ inputOperations };
+        std::ostringstream hugePagesOutput;
+        stages.push_back(measure_stage("endToEndHugePages", counters, [&] {
+            mybank::process_operations(hugePagesInput, hugePagesOutput, hugePagesOptions);
+        }));
+    }
+
+    return stages;
+}
+
+// Best of at least three runs and minSeconds, after a warm up run counting the allocations
+auto run_corpus(
+        const std::string &inputOperations,
+        const benchmark_options &options,
+        mybank::test::PerfCounters *counters)
+        -> corpus_result
+{
+    corpus_result result{};
+    result.operations = static_cast<std::size_t>(std::count(inputOperations.begin(), inputOperations.end(), '\n'));
+
+    const auto allocationsBefore{ allocations.load() };
+    run_once(inputOperations);
+    result.allocationsPerOperation = static_cast<double>(allocations.load() - allocationsBefore)/result.operations;
+
+    auto best{ std::chrono::duration<double>::max() };
+    std::chrono::duration<double> total{ 0 };
+    for (auto runs{ 0 }; runs < 3 || total.count() < options.minSeconds; ++runs)
+    {
+        const auto elapsed{ run_once(inputOperations) };
+        best = std::min(best, elapsed);
+        total += elapsed;
+    }
+
+    result.operationsPerSecond = result.operations/best.count();
+
+    if (counters != nullptr)
+    {
+        result.stages = measure_stages(inputOperations, options, *counters);
+    }
+
+    return result;
+}
+
+auto parse_arguments(int argc, char **argv) -> std::optional<benchmark_options>
+{
+    benchmark_options options{};
+
+    for (auto i{ 1 }; i < argc; ++i)
+    {
+        const std::string_view argument{ argv[i] };
+        const auto value{ argument.substr(std::min(argument.find('=') + 1, argument.size())) };
+
+        if (argument.rfind("--corpus=", 0) == 0)
+        {
+            options.corpusDirectory = value;
+        }
+        else if (argument.rfind("--baseline=", 0) == 0)
+        {
+            options.baselinePath = value;
+        }
+        else if (argument.rfind("--output=", 0) == 0)
+        {
+            options.outputPath = value;
+        }
+        else if (argument.rfind("--tolerance=", 0) == 0)
+        {
+            options.tolerance = std::strtod(std::string{ value }.c_str(), nullptr);
+        }
+        else if (argument.rfind("--min-seconds=", 0) == 0)
+        {
+            options.minSeconds = std::strtod(std::string{ value }.c_str(), nullptr);
+        }
+        else if (argument == "--record")
+        {
+            options.record = true;
+        }
+        else if (argument == "--allocations-only")
+        {
+            options.allocationsOnly = true;
+        }
+        else if (argument == "--perf-counters")
+        {
+            options.perfCounters = true;
+        }
+        else if (argument == "--huge-pages=transparent")
+        {
+            options.hugePages = mybank::HugePages::TRANSPARENT;
+        }
+        else if (argument == "--huge-pages=hugetlbfs")
+        {
+            options.hugePages = mybank::HugePages::HUGETLBFS;
+        }
+        else
+        {
+            std::fprintf(stderr, "unknown argument %s\n", argv[i]);
+            return std::nullopt;
+        }
+    }
+
+    return options;
+}
+
+// Counts the corpora slower or allocating more than the baseline allows
+auto count_regressions(const json &results, const json &baseline, const benchmark_options &options) -> int
+{
+    auto regressions{ 0 };
+
+    for (const auto &[name, expected] : baseline.at("corpora").items())
+    {
+        if (!results.at("corpora").contains(name))
+        {
+            continue;
+        }
+
+        const auto &actual{ results.at("corpora").at(name) };
+        const auto throughput{ actual.at("operationsPerSecond").get<double>() };
+        const auto minThroughput{ expected.at("operationsPerSecond").get<double>()*(1 - options.tolerance) };
+        const auto allocationsPerOperation{ actual.at("allocationsPerOperation").get<double>() };
+        const auto maxAllocations{ expected.at("allocationsPerOperation").get<double>()*(1 + options.tolerance) };
+
+        if (!options.allocationsOnly && throughput < minThroughput)
+        {
+            std::printf("REGRESSION %s: %.0f operations/s, baseline allows %.0f\n", name.c_str(), throughput, minThroughput);
+            ++regressions;
+        }
+
+        if (allocationsPerOperation > maxAllocations)
+        {
+            std::printf("REGRESSION %s: %.2f allocations/operation, baseline allows %.2f\n",
+                        name.c_str(), allocationsPerOperation, maxAllocations);
+            ++regressions;
+        }
+    }
+
+    return regressions;
+}
+
+} // namespace
+
+// Counts every allocation of the process, the library's included
+void *operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (auto *pointer{ std::malloc(size == 0 ? 1 : size) })
+    {
+        return pointer;
+    }
+
+    // Aborting instead of throwing std::bad_alloc keeps this usable with -fno-exceptions
+    std::abort();
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+// The default memory resource of the pmr containers allocates through the aligned form
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    const auto align{ std::max(static_cast<std::size_t>(alignment), sizeof(void *)) };
+    if (auto *pointer{ std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1)/align*align) })
+    {
+        return pointer;
+    }
+
+    std::abort();
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+// Runs every corpus in --corpus, writes the results as JSON to --output (or the standard output)
+// and fails when a corpus is slower or allocates more than --baseline allows within --tolerance.
+// --record writes the results to --baseline instead of comparing them.
+// --perf-counters adds the time and hardware counters of each stage per operation,
+// --huge-pages=transparent|hugetlbfs the stages holding the history in huge pages next to them.
+int main(int argc, char **argv)
+{
+    const auto options{ parse_arguments(argc, argv) };
+    if (!options.has_value())
+    {
+        return 2;
+    }
+
+    std::optional<mybank::test::PerfCounters> counters{};
+    if (options->perfCounters)
+    {
+        counters.emplace();
+        if (!counters->any_available())
+        {
+            std::fprintf(stderr, "hardware counters unavailable (%s), reporting the time of each stage only\n",
+                         counters->error().c_str());
+        }
+        else if (!counters->error().empty())
+        {
+            std::fprintf(stderr, "some hardware counters unavailable (%s)\n", counters->error().c_str());
+        }
+    }
+
+    json results{ { "corpora", json::object() } };
+    for (const auto *name : corpusNames)
+    {
+        const auto path{ std::filesystem::path{ options->corpusDirectory } / (std::string{ name } + ".txt") };
+        const auto inputOperations{ read_file(path) };
+        if (inputOperations.empty())
+        {
+            std::fprintf(stderr, "missing corpus %s\n", path.c_str());
+            return 2;
+        }
+
+        const auto result{ run_corpus(inputOperations, *options, counters.has_value() ? &counters.value() : nullptr) };
+        results["corpora"][name] = {
+                { "operations", result.operations },
+                { "operationsPerSecond", result.operationsPerSecond },
+                { "allocationsPerOperation", result.allocationsPerOperation }
+        };
+        std::printf("%-16s %10.0f operations/s %8.2f allocations/operation\n",
+                    name, result.operationsPerSecond, result.allocationsPerOperation);
+
+        for (const auto &stage : result.stages)
+        {
+            auto &stageJson{ results["corpora"][name]["stages"][stage.name] };
+            stageJson["nanosecondsPerOperation"] = stage.nanoseconds/result.operations;
+            std::printf("  %-18s %10.1f ns/operation", stage.name, stage.nanoseconds/result.operations);
+
+            for (std::size_t i{ 0 }; i < stage.counts.size(); ++i)
+            {
+                if (stage.counts[i].has_value())
+                {
+                    const auto perOperation{ stage.counts[i].value()/result.operations };
+                    stageJson[std::string{ mybank::test::perfCounters[i].name } + "PerOperation"] = perOperation;
+                    std::printf(" %10.1f %s", perOperation, mybank::test::perfCounters[i].name);
+                }
+            }
+
+            std::printf("\n");
+        }
+    }
+
+    if (options->record)
+    {
+        std::ofstream{ options->baselinePath } << results.dump(4) << '\n';
+        return 0;
+    }
+
+    if (options->outputPath.empty())
+    {
+        std::printf("%s\n", results.dump(4).c_str());
+    }
+    else
+    {
+        std::ofstream{ options->outputPath } << results.dump(4) << '\n';
+    }
+
+    if (options->baselinePath.empty())
+    {
+        return 0;
+    }
+
+    const auto baseline = json::parse(read_file(options->baselinePath), nullptr, false);
+    if (baseline.is_discarded() || !baseline.contains("corpora"))
+    {
+        std::fprintf(stderr, "invalid baseline %s\n", options->baselinePath.c_str());
+        return 2;
+    }
+
+    return (count_regressions(results, baseline, *options) == 0) ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+#ifndef PROCESS_OPERATIONS_TEST_PERF_COUNTERS_H
+#define PROCESS_OPERATIONS_TEST_PERF_COUNTERS_H
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace mybank::test
+{
+
+struct perf_counter
+{
+    const char *name;
+    uint32_t type;
+    uint64_t config;
+};
+
+#ifdef __linux__
+inline constexpr std::array<perf_counter, 5> perfCounters{ {
+    { "cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { "instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { "cacheMisses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { "branchMisses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    { "dtlbMisses", PERF_TYPE_HW_CACHE,
+      PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) }
+} };
+#else
+inline constexpr std::array<perf_counter, 0> perfCounters{};
+#endif
+
+// Counts, scaled up when the kernel multiplexed the counter, std::nullopt for the counters it could not open
+using perf_counts = std::array<std::optional<double>, perfCounters.size()>;
+
+// User space hardware counters of the calling thread through perf_event_open (Linux only).
+// Counters the kernel, the CPU or a virtual machine do not provide stay closed and read as std::nullopt,
+// so callers keep measuring time when none is available.
+class PerfCounters
+{
+public:
+    PerfCounters()
+    {
+#ifdef __linux__
+        for (std::size_t i{ 0 }; i < perfCounters.size(); ++i)
+        {
+            perf_event_attr attributes{};
+            std::memset(&attributes, 0, sizeof(attributes));
+            attributes.size = sizeof(attributes);
+            attributes.type = perfCounters[i].type;
+            attributes.config = perfCounters[i].config;
+            attributes.disabled = 1;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            fds_[i] = static_cast<int>(::syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0));
+            if (fds_[i] < 0 && error_.empty())
+            {
+                error_ = std::string{ perfCounters[i].name } + ": " + std::strerror(errno);
+            }
+        }
+#else
+        error_ = "perf_event_open is only available on Linux";
+#endif
+    }
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    ~PerfCounters()
+    {
+#ifdef __linux__
+        for (const auto fd : fds_)
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+        }
+#endif
+    }
+
+    auto any_available() const -> bool
+    {
+        for (const auto fd : fds_)
+        {
+            if (fd >= 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Why the first unavailable counter could not be opened, empty when all of them were
+    auto error() const -> const std::string &
+    {
+        return error_;
+    }
+
+    void start()
+    {
+#ifdef __linux__
+        for (const auto fd : fds_)
+        {
+            if (fd >= 0)
+            {
+                ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    auto stop() -> perf_counts
+    {
+        perf_counts counts{};
+#ifdef __linux__
+        for (const auto fd : fds_)
+        {
+            if (fd >= 0)
+            {
+                ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+
+        for (std::size_t i{ 0 }; i < fds_.size(); ++i)
+        {
+            // value, time enabled, time running
+            uint64_t values[3]{};
+            if (fds_[i] < 0 || ::read(fds_[i], values, sizeof(values)) != static_cast<ssize_t>(sizeof(values)) || values[2] == 0)
+            {
+                continue;
+            }
+
+            counts[i] = static_cast<double>(values[0])*static_cast<double>(values[1])/static_cast<double>(values[2]);
+        }
+#endif
+        return counts;
+    }
+
+private:
+    std::array<int, perfCounters.size()> fds_{ make_closed() };
+    std::string error_{};
+
+    static constexpr auto make_closed() -> std::array<int, perfCounters.size()>
+    {
+        std::array<int, perfCounters.size()> fds{};
+        for (auto &fd : fds)
+        {
+            fd = -1;
+        }
+
+        return fds;
+    }
+};
+
+} // namespace mybank::test
+
+#endif // PROCESS_OPERATIONS_TEST_PERF_COUNTERS_H
@@ -0,0 +1,115 @@
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <random>
+#include <string>
+
+#include "catch.hpp"
+
+#include "../src/decode_kernels.h"
+
+TEST_CASE( "Test SWAR decode kernels against their scalar versions", "[decode_kernels]" )
+{
+    std::mt19937_64 random{ 20190213 };
+
+    SECTION( "with random digit sequences, then parse_digits and count_digits agree with the scalar parser" )
+    {
+        constexpr auto characters{ "0123456789012345678901234567890123456789-.,x}\"/:" };
+
+        for (auto i{ 0 }; i < 100000; ++i)
+        {
+            // Random prefix so the masked loads see arbitrary bytes before the number
+            std::string line(random() % 12, '"');
+            const auto first{ line.size() };
+            const auto length{ 1 + random() % 20 };
+            for (std::size_t j{ 0 }; j < length; ++j)
+            {
+                line += characters[random() % 48];
+            }
+            line += (random() % 2 == 0) ? "," : "}}";
+
+            const auto last{ first + 1 + random() % length };
+
+            int64_t swarValue{ -1 };
+            int64_t scalarValue{ -1 };
+            const auto swarParsed{ mybank::parse_digits(line, first, last, swarValue) };
+            const auto scalarParsed{ mybank::parse_digits_scalar(line, first, last, scalarValue) };
+
+            REQUIRE( swarParsed == scalarParsed );
+            REQUIRE( swarValue == scalarValue );
+
+            auto scalarDigits{ first };
+            while (scalarDigits < line.size() && line[scalarDigits] >= '0' && line[scalarDigits] <= '9')
+            {
+                ++scalarDigits;
+            }
+            REQUIRE( mybank::count_digits(line, first) == scalarDigits - first );
+        }
+    }
+
+    SECTION( "with random and mutated times, then the fixed width kernel agrees with strptime and mktime" )
+    {
+        const auto two_digits = [&](int limit) {
+            const auto value{ static_cast<int>(random() % limit) };
+            return std::string{ static_cast<char>('0' + value / 10), static_cast<char>('0' + value % 10) };
+        };
+
+        for (auto i{ 0 }; i < 20000; ++i)
+        {
+            auto time{ std::to_string(1970 + random() % 100) + "-" + two_digits(14) + "-" + two_digits(33) + "T" +
+                       two_digits(26) + ":" + two_digits(62) + ":" + two_digits(62) + "." +
+                       two_digits(100) + std::to_string(random() % 10) + "Z" };
+
+            if (random() % 4 == 0)
+            {
+                time[random() % time.size()] = "09:-.TZx"[random() % 8];
+            }
+
+            time_t fastMillis;
+            if (mybank::iso8601_to_millis_fast(time, fastMillis))
+            {
+                REQUIRE( fastMillis == mybank::iso8601_to_millis_scalar(time) );
+            }
+            REQUIRE( mybank::iso8601_to_millis(time) == mybank::iso8601_to_millis_scalar(time) );
+        }
+    }
+
+    SECTION( "with days changing the UTC offset of a time zone, then the fixed width kernel agrees with mktime" )
+    {
+        const auto *previous{ std::getenv("TZ") };
+        const std::string previousZone{ (previous != nullptr) ? previous : "" };
+
+        // Lord Howe moves by 30 minutes, New York by an hour, Moscow changed its standard offset in 2014
+        for (const auto *zone : { "Australia/Lord_Howe", "America/New_York", "Europe/Moscow" })
+        {
+            setenv("TZ", zone, 1);
+            tzset();
+
+            for (const auto *month : { "2014-10", "2019-03", "2019-04", "2019-10", "2019-11" })
+            {
+                for (auto day{ 1 }; day <= 31; ++day)
+                {
+                    for (auto minutes{ 0 }; minutes < 24*60; minutes += 15)
+                    {
+                        char time[32];
+                        std::snprintf(time, sizeof(time), "%s-%02dT%02d:%02d:07.250Z", month, day, minutes/60, minutes%60);
+
+                        time_t fastMillis;
+                        REQUIRE( mybank::iso8601_to_millis_fast(time, fastMillis) );
+                        REQUIRE( fastMillis == mybank::iso8601_to_millis_scalar(time) );
+                    }
+                }
+            }
+        }
+
+        if (previous != nullptr)
+        {
+            setenv("TZ", previousZone.c_str(), 1);
+        }
+        else
+        {
+            unsetenv("TZ");
+        }
+        tzset();
+    }
+}
@@ -0,0 +1,120 @@
+#include <sstream>
+#include <string>
+
+#include "catch.hpp"
+
+#include "../include/process_operations/process_operations.h"
+#include "generate_operations.h"
+
+namespace
+{
+
+auto process_delta(const std::string &inputOperations, mybank::process_options options) -> std::string
+{
+    options.deltaOutput = true;
+
+    std::istringstream input{ inputOperations };
+    std::ostringstream output;
+    mybank::process_operations(input, output, options);
+
+    return output.str();
+}
+
+} // namespace
+
+TEST_CASE( "Test delta output", "[delta]" )
+{
+    const std::string inputOperations{
+        "{\"transaction\":{\"merchant\":\"Burger King\",\"amount\":20,\"time\":\"2019-02-13T10:00:00.000Z\"}}\n"
+        "{\"account\":{\"activeAccount\":true,\"availableLimit\":100}}\n"
+        "not json\n"
+        "{\"transaction\":{\"merchant\":\"Burger King\",\"amount\":20,\"time\":\"2019-02-13T10:00:00.000Z\"}}\n"
+        "{\"deposit\":{\"amount\":20}}\n"
+        "{\"transaction\":{\"merchant\":\"Habbib's\",\"amount\":90,\"time\":\"2019-02-13T10:01:00.000Z\"}}\n"
+        "{\"account\":{\"activeAccount\":true,\"availableLimit\":350}}\n"
+        "{\"transaction\":{\"merchant\":\"Habbib's\",\"amount\":20,\"time\":\"2019-02-13T10:01:30.000Z\"}}\n"
+    };
+
+    SECTION( "with skipped, unknown, accepted and rejected operations, then only the changes are written with their line number" )
+    {
+        REQUIRE( process_delta(inputOperations, {}) ==
+                 "{\"seq\":2,\"account\":{\"activeAccount\":true,\"availableLimit\":100}}\n"
+                 "{\"seq\":4,\"availableLimit\":80}\n"
+                 "{\"seq\":6,\"violations\":[\"insufficient-limit\"]}\n"
+                 "{\"seq\":7,\"violations\":[\"account-already-initialized\"]}\n"
+                 "{\"seq\":8,\"availableLimit\":60}\n" );
+    }
+
+    SECTION( "with lines fed one at a time, then the line numbers continue across calls" )
+    {
+        mybank::process_options options{};
+        options.deltaOutput = true;
+        mybank::Authorizer authorizer{ options };
+
+        std::string output{};
+        std::istringstream lines{ inputOperations };
+        for (std::string inputLine; std::getline(lines, inputLine);)
+        {
+            output += authorizer.process(inputLine);
+        }
+
+        REQUIRE( output == process_delta(inputOperations, {}) );
+    }
+
+    SECTION( "with an authorizer move assigned halfway, then the line numbers continue in the one moved to" )
+    {
+        mybank::process_options options{};
+        options.deltaOutput = true;
+        mybank::Authorizer authorizer{ options };
+        mybank::Authorizer moved{ options };
+
+        auto *current{ &authorizer };
+        std::string output{};
+        std::istringstream lines{ inputOperations };
+        for (std::string inputLine; std::getline(lines, inputLine);)
+        {
+            if (inputLine.find("deposit") != std::string::npos)
+            {
+                moved = std::move(authorizer);
+                current = &moved;
+            }
+            output += current->process(inputLine);
+        }
+
+        REQUIRE( output == process_delta(inputOperations, {}) );
+    }
+
+    SECTION( "with every execution mode, then the delta output is the same as the sequential one" )
+    {
+        const auto operations{ mybank::test::generate_operations(3000) };
+        const auto expected{ process_delta(operations, {}) };
+
+        mybank::process_options pipelined{};
+        pipelined.pipelined = true;
+        pipelined.pipelineCapacity = 16;
+        REQUIRE( process_delta(operations, pipelined) == expected );
+
+        mybank::process_options parallelDecode{};
+        parallelDecode.decodeThreads = 2;
+        parallelDecode.decodeChunkLines = 7;
+        REQUIRE( process_delta(operations, parallelDecode) == expected );
+    }
+
+    SECTION( "with transactions reordered, then the changes keep the arrival order and line numbers" )
+    {
+        const std::string lateOperations{
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":100}}\n"
+            "{\"transaction\":{\"merchant\":\"Habbib's\",\"amount\":90,\"time\":\"2019-02-13T10:01:00.000Z\"}}\n"
+            "{\"transaction\":{\"merchant\":\"Burger King\",\"amount\":20,\"time\":\"2019-02-13T10:00:00.000Z\"}}\n"
+            "{\"deposit\":{\"amount\":20}}\n"
+        };
+
+        mybank::process_options reordered{};
+        reordered.reorderLatenessMillis = 60*1000;
+
+        REQUIRE( process_delta(lateOperations, reordered) ==
+                 "{\"seq\":1,\"account\":{\"activeAccount\":true,\"availableLimit\":100}}\n"
+                 "{\"seq\":2,\"violations\":[\"insufficient-limit\"]}\n"
+                 "{\"seq\":3,\"availableLimit\":80}\n" );
+    }
+}
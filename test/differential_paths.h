@@ -0,0 +1,52 @@
+#ifndef PROCESS_OPERATIONS_TEST_DIFFERENTIAL_PATHS_H
+#define PROCESS_OPERATIONS_TEST_DIFFERENTIAL_PATHS_H
+
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../include/process_operations/process_operations.h"
+
+namespace mybank::test
+{
+
+// Output of every execution path that must match the reference implementation, by name.
+// The reorder mode is left out since it authorizes in time order on purpose.
+inline auto optimized_outputs(const std::string &inputOperations) -> std::vector<std::pair<std::string, std::string>>
+{
+    const auto run = [&inputOperations](const mybank::process_options &options) {
+        std::istringstream input{ inputOperations };
+        std::ostringstream output;
+        mybank::process_operations(input, output, options);
+        return output.str();
+    };
+
+    std::vector<std::pair<std::string, std::string>> outputs{};
+    outputs.emplace_back("sequential", run({}));
+
+    mybank::Authorizer authorizer{};
+    std::string authorizerOutput{};
+    std::istringstream lines{ inputOperations };
+    for (std::string inputLine; std::getline(lines, inputLine);)
+    {
+        authorizerOutput += authorizer.process(inputLine);
+    }
+    outputs.emplace_back("authorizer lines", std::move(authorizerOutput));
+
+    mybank::process_options pipelined{};
+    pipelined.pipelined = true;
+    pipelined.pipelineCapacity = 4;
+    outputs.emplace_back("pipelined", run(pipelined));
+
+    mybank::process_options parallelDecode{};
+    parallelDecode.decodeThreads = 2;
+    parallelDecode.decodeChunkLines = 7;
+    outputs.emplace_back("parallel decode", run(parallelDecode));
+
+    return outputs;
+}
+
+} // namespace mybank::test
+
+#endif // PROCESS_OPERATIONS_TEST_DIFFERENTIAL_PATHS_H
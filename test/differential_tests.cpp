@@ -0,0 +1,40 @@
+#include <random>
+#include <string>
+
+#include "catch.hpp"
+
+#include "differential_paths.h"
+#include "generate_operations.h"
+#include "reference_authorizer.h"
+
+TEST_CASE( "Test optimized paths against the reference implementation", "[differential]" )
+{
+    SECTION( "with the generated operations, then every path writes the reference output" )
+    {
+        const auto inputOperations{ mybank::test::generate_operations(3000) };
+        const auto expected{ mybank::test::reference::process_operations(inputOperations) };
+
+        for (const auto &[path, output] : mybank::test::optimized_outputs(inputOperations))
+        {
+            INFO( path );
+            REQUIRE( output == expected );
+        }
+    }
+
+    SECTION( "with random streams of out of order, duplicated and malformed operations, then every path writes the reference output" )
+    {
+        std::mt19937_64 random{ 20190213 };
+
+        for (auto run{ 0 }; run < 200; ++run)
+        {
+            const auto inputOperations{ mybank::test::generate_random_operations(random, 1 + static_cast<int>(random() % 400)) };
+            const auto expected{ mybank::test::reference::process_operations(inputOperations) };
+
+            for (const auto &[path, output] : mybank::test::optimized_outputs(inputOperations))
+            {
+                INFO( path << " on input:\n" << inputOperations );
+                REQUIRE( output == expected );
+            }
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "../include/process_operations/process_operations.h"
+
+namespace
+{
+
+auto process_lines(const std::vector<std::string> &lines, const std::string &linePrefix) -> std::string
+{
+    std::ostringstream input;
+    for (const auto &line : lines)
+    {
+        input << linePrefix << line << '\n';
+    }
+
+    mybank::account account{ true, 1000 };
+    std::istringstream inputStream{ input.str() };
+    std::ostringstream output;
+
+    mybank::process_transactions(account, inputStream, output);
+
+    return output.str();
+}
+
+} // namespace
+
+TEST_CASE( "Test fast path decoding", "[fast_decode]" )
+{
+    SECTION( "with producer shaped and unusual lines, then output is the same as with the general decoder" )
+    {
+        // A leading space never matches the fast path, so those lines always use the general decoder
+        const std::vector<std::string> lines{
+            R"({"account":{"activeAccount":true,"availableLimit":100}})",
+            R"({"account":{"activeAccount":false,"availableLimit":-7}})",
+            R"({"transaction":{"merchant":"Burger King","amount":20,"time":"2019-02-13T10:00:00.000Z"}})",
+            R"({"transaction":{"merchant":"Burger King","amount":20,"time":"2019-02-13T10:00:30.000Z"}})",
+            R"({"transaction":{"merchant":"Habbib's","amount":0,"time":"2019-02-13T10:00:31.123Z"}})",
+            R"({"transaction":{"merchant":"Habbib's","amount":-0,"time":"2019-02-13T10:00:31.124Z"}})",
+            R"({"transaction":{"merchant":"A long merchant name crossing sixteen byte blocks","amount":1,"time":"2019-02-13T11:00:00.000Z"}})",
+            R"({"transaction":{"merchant":"","amount":2,"time":"2019-02-13T12:00:00.000Z"}})",
+            R"({"transaction":{"merchant":"Esc\"aped","amount":3,"time":"2019-02-13T13:00:00.000Z"}})",
+            R"({"transaction":{"merchant":"Café","amount":4,"time":"2019-02-13T14:00:00.000Z"}})",
+            "{\"transaction\":{\"merchant\":\"Caf\xc3\xa9\",\"amount\":5,\"time\":\"2019-02-13T15:00:00.000Z\"}}",
+            "{\"transaction\":{\"merchant\":\"Invalid \xff UTF-8\",\"amount\":5,\"time\":\"2019-02-13T15:30:00.000Z\"}}",
+            R"({"transaction":{"merchant":"Burger King","amount":007,"time":"2019-02-13T16:00:00.000Z"}})",
+            R"({"transaction":{"merchant":"Burger King","amount":7.5,"time":"2019-02-13T16:00:00.000Z"}})",
+            R"({"transaction":{"merchant":"Burger King","amount":1e2,"time":"2019-02-13T16:00:00.000Z"}})",
+            R"({"transaction":{"merchant":"Burger King","amount":123456789012345678,"time":"2019-02-13T17:00:00.000Z"}})",
+            R"({"transaction":{"merchant":"Burger King","amount":1234567890123456789,"time":"2019-02-13T18:00:00.000Z"}})",
+            R"({"transaction":{"merchant":"Burger King","amount":30,"time":"2019-02-13T19:00:00Z"}})",
+            R"({"transaction":{"merchant":"Burger King","amount":30,"time":"2019-02-13T19:00:00.000Z"}}trailing)",
+            R"({"transaction":{"merchant":"Burger King","amount":30,"time":"2019-02-13T19:00:00.000Z"})",
+            R"({"transaction":{"amount":30,"merchant":"Burger King","time":"2019-02-13T20:00:00.000Z"}})",
+            R"({"transaction":{"merchant":"Burger King","amount":30,"time":"2019-02-13T21:00:00.000Z","extra":1}})",
+            R"({"account":{"activeAccount":true,"availableLimit":100},"extra":1})",
+            R"({"account":{"activeAccount":1,"availableLimit":100}})",
+        };
+
+        const auto fastOutput{ process_lines(lines, "") };
+        const auto generalOutput{ process_lines(lines, " ") };
+
+        REQUIRE( !fastOutput.empty() );
+        REQUIRE( fastOutput == generalOutput );
+    }
+}
@@ -0,0 +1,98 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include "../differential_paths.h"
+#include "../generate_operations.h"
+#include "../reference_authorizer.h"
+
+namespace
+{
+
+// Aborts, so the fuzzer keeps the input, when an optimized path disagrees with the reference
+void check_paths(const std::string &inputOperations)
+{
+    const auto expected{ mybank::test::reference::process_operations(inputOperations) };
+
+    for (const auto &[path, output] : mybank::test::optimized_outputs(inputOperations))
+    {
+        if (output != expected)
+        {
+            std::fprintf(stderr, "%s path differs from the reference on input:\n%s\nexpected:\n%s\ngot:\n%s\n",
+                         path.c_str(), inputOperations.c_str(), expected.c_str(), output.c_str());
+            std::abort();
+        }
+    }
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    check_paths(std::string{ reinterpret_cast<const char *>(data), size });
+    return 0;
+}
+
+#ifndef MYBANK_LIBFUZZER
+
+namespace
+{
+
+void check_file(const std::filesystem::path &path)
+{
+    std::ifstream file{ path, std::ios::binary };
+    check_paths(std::string{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} });
+}
+
+} // namespace
+
+// Without libFuzzer: replays the given files and directories, then checks -runs=N generated streams
+// starting from -seed=S. Other libFuzzer flags are ignored, so both builds take the same command line.
+int main(int argc, char **argv)
+{
+    unsigned long long runs{ 0 };
+    unsigned long long seed{ 20190213 };
+
+    for (auto i{ 1 }; i < argc; ++i)
+    {
+        const std::string_view argument{ argv[i] };
+        if (argument.rfind("-runs=", 0) == 0)
+        {
+            runs = std::strtoull(argv[i] + 6, nullptr, 10);
+        }
+        else if (argument.rfind("-seed=", 0) == 0)
+        {
+            seed = std::strtoull(argv[i] + 6, nullptr, 10);
+        }
+        else if (argument.rfind('-', 0) != 0)
+        {
+            if (std::filesystem::is_directory(argv[i]))
+            {
+                for (const auto &entry : std::filesystem::directory_iterator{ argv[i] })
+                {
+                    check_file(entry.path());
+                }
+            }
+            else
+            {
+                check_file(argv[i]);
+            }
+        }
+    }
+
+    std::mt19937_64 random{ seed };
+    for (unsigned long long run{ 0 }; run < runs; ++run)
+    {
+        check_paths(mybank::test::generate_random_operations(random, 1 + static_cast<int>(random() % 400)));
+    }
+
+    return 0;
+}
+
+#endif
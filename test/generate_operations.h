@@ -0,0 +1,119 @@
+#ifndef PROCESS_OPERATIONS_TEST_GENERATE_OPERATIONS_H
+#define PROCESS_OPERATIONS_TEST_GENERATE_OPERATIONS_H
+
+#include <algorithm>
+#include <ctime>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace mybank::test
+{
+
+// Account followed by count transactions from a few merchants spread over an hour,
+// with invalid lines and repeated accounts interleaved
+inline auto generate_operations(int count) -> std::string
+{
+    std::ostringstream input;
+    input << R"({"account":{"activeAccount":true,"availableLimit":100000}})" << '\n';
+
+    for (auto i{ 0 }; i < count; ++i)
+    {
+        if (i % 17 == 0)
+        {
+            input << "not json" << '\n';
+        }
+        else if (i % 23 == 0)
+        {
+            input << R"({"account":{"activeAccount":true,"availableLimit":5}})" << '\n';
+        }
+
+        const auto seconds{ (i * 37) % 3600 };
+        input << R"({"transaction":{"merchant":"Merchant )" << i % 3
+              << R"(","amount":)" << 10 + i % 4
+              << R"(,"time":"2019-02-13T)" << 10 + seconds / 3600 << ':'
+              << (seconds / 60 % 60 < 10 ? "0" : "") << seconds / 60 % 60 << ':'
+              << (seconds % 60 < 10 ? "0" : "") << seconds % 60 << R"(.000Z"}})" << '\n';
+    }
+
+    return input.str();
+}
+
+// Account and transaction lines meant to reach the corners of the decoders and the rules: repeated and
+// inactive accounts, few merchants and amounts so transactions repeat, times out of order and at the same
+// millisecond, other time layouts, and malformed lines, mistyped fields and unusual spacing mixed in
+inline auto generate_random_operations(std::mt19937_64 &random, int count) -> std::string
+{
+    constexpr const char *merchants[]{ "Burger King", "Habbib's", R"(Caf\u00e9)", R"(Tab\tBar)", "McDonald's", "" };
+    constexpr const char *malformedLines[]{
+        "not json", "", "{", "{}", "[]", "null", R"({"account":{}})", R"({"transaction":{}})",
+        R"({"account":{"activeAccount":"true","availableLimit":100}})",
+        R"({"account":{"activeAccount":true,"availableLimit":1.5}})",
+        R"({"transaction":{"merchant":7,"amount":20,"time":"2019-02-13T10:00:00.000Z"}})",
+        R"({"transaction":{"merchant":"Burger King","amount":"20","time":"2019-02-13T10:00:00.000Z"}})",
+        R"({"transaction":{"merchant":"Burger King","amount":20,"time":false}})",
+        R"({"transaction":{"merchant":"Burger King","amount":20}})",
+        R"({"transaction":{"merchant":"Burger King","amount":1e2,"time":"2019-02-13T10:00:00.000Z"}})",
+        R"({"transaction":{"merchant":"Burger King","amount":020,"time":"2019-02-13T10:00:00.000Z"}})"
+    };
+
+    std::ostringstream input;
+    time_t seconds{ 10*3600 };
+
+    for (auto i{ 0 }; i < count; ++i)
+    {
+        const auto kind{ random() % 20 };
+        if (kind == 0)
+        {
+            input << R"({"account":{"activeAccount":)" << ((random() % 4 == 0) ? "false" : "true")
+                  << R"(,"availableLimit":)" << static_cast<int64_t>(random() % 2000) - 100 << "}}\n";
+            continue;
+        }
+
+        if (kind == 1)
+        {
+            const std::string line{ malformedLines[random() % std::size(malformedLines)] };
+            input << line.substr(0, (random() % 3 == 0) ? random() % (line.size() + 1) : line.size()) << '\n';
+            continue;
+        }
+
+        // Mostly forward, sometimes far back or at the same time again
+        const auto step{ random() % 10 };
+        seconds += (step < 6) ? static_cast<time_t>(random() % 50) : (step < 8) ? 0 : -static_cast<time_t>(random() % 400);
+        seconds = std::max<time_t>(seconds, 0);
+
+        std::ostringstream time;
+        time << "2019-02-13T" << (seconds / 3600 % 24 < 10 ? "0" : "") << seconds / 3600 % 24 << ':'
+             << (seconds / 60 % 60 < 10 ? "0" : "") << seconds / 60 % 60 << ':'
+             << (seconds % 60 < 10 ? "0" : "") << seconds % 60;
+        switch (random() % 12)
+        {
+            case 0: time << 'Z'; break;
+            case 1: time << ".5Z"; break;
+            case 2: time << '.' << random() % 1000 << "+01:00"; break;
+            case 3: case 4: case 5: case 6: time << ".000Z"; break;
+            default: time << '.' << 100 + random() % 900 << 'Z'; break;
+        }
+
+        const auto amount{ (random() % 10 == 0) ? static_cast<int64_t>(random() % 2000) - 1000 : static_cast<int64_t>(1 + random() % 4)*10 };
+        const auto *separator{ (random() % 8 == 0) ? ", " : "," };
+
+        if (random() % 6 == 0)
+        {
+            input << R"({ "transaction" : { "time":")" << time.str() << R"(")" << separator << R"("amount":)" << amount
+                  << separator << R"("merchant":")" << merchants[random() % std::size(merchants)] << R"(" } })" << '\n';
+        }
+        else
+        {
+            input << R"({"transaction":{"merchant":")" << merchants[random() % std::size(merchants)] << R"(")" << separator
+                  << R"("amount":)" << amount << separator << R"("time":")" << time.str() << R"("}})" << '\n';
+        }
+    }
+
+    return input.str();
+}
+
+} // namespace mybank::test
+
+#endif // PROCESS_OPERATIONS_TEST_GENERATE_OPERATIONS_H
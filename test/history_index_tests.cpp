@@ -0,0 +1,94 @@
+#include <cmath>
+#include <deque>
+#include <map>
+#include <random>
+#include <string>
+
+#include "catch.hpp"
+
+#include "../include/process_operations/process_operations.h"
+
+namespace
+{
+
+// The history scan the doubled transaction check used before the merchant and amount index
+auto reference_doubled(
+        const mybank::transaction_history &validTransactions,
+        const mybank::transaction &transaction)
+        -> bool
+{
+    constexpr auto smallInterval{ 2*60*1000 };
+
+    double timediff;
+    auto maxEqualTransactionsSmallInterval{ 0 };
+    std::deque<mybank::transaction> transactionsSmallInterval{};
+    for (auto crit{ validTransactions.crbegin() };
+         crit != validTransactions.crend() &&
+         (timediff = difftime(transaction.timeInMillis, crit->first)) < smallInterval;
+         ++crit)
+    {
+        if (fabs(timediff) < smallInterval)
+        {
+            transactionsSmallInterval.push_back(crit->second);
+            while (difftime(transactionsSmallInterval.front().timeInMillis, crit->first) > smallInterval)
+            {
+                transactionsSmallInterval.pop_front();
+            }
+
+            auto currEqualTransactionsSmallInterval{ 0 };
+            for (const auto &t : transactionsSmallInterval)
+            {
+                if (t.merchant == transaction.merchant && t.amount == transaction.amount)
+                {
+                    ++currEqualTransactionsSmallInterval;
+                }
+            }
+
+            if (currEqualTransactionsSmallInterval > maxEqualTransactionsSmallInterval)
+            {
+                maxEqualTransactionsSmallInterval = currEqualTransactionsSmallInterval;
+            }
+        }
+    }
+
+    return maxEqualTransactionsSmallInterval > 1;
+}
+
+} // namespace
+
+TEST_CASE( "Test doubled transaction check against the history scan", "[history_index]" )
+{
+    std::mt19937_64 random{ 20190213 };
+
+    for (auto run{ 0 }; run < 50; ++run)
+    {
+        mybank::Authorizer authorizer{};
+        authorizer.restore({ true, 1000000000 }, {});
+        mybank::transaction_history referenceTransactions{};
+
+        // Sparse enough that high frequency rarely rejects, few merchants and amounts so they repeat
+        time_t time{ 1550052000000 };
+        for (auto i{ 0 }; i < 2000; ++i)
+        {
+            switch (random() % 4)
+            {
+                case 0: time -= static_cast<time_t>(random() % 400000); break;
+                case 1: time += 120000; break;
+                default: time += static_cast<time_t>(random() % 200000); break;
+            }
+
+            const mybank::transaction transaction{
+                static_cast<int64_t>(1 + random() % 2), "Merchant " + std::to_string(random() % 2), "", time };
+            const auto expected{ reference_doubled(referenceTransactions, transaction) };
+
+            const auto &violations{ authorizer.process(transaction) };
+            const auto doubled{ !violations.empty() && violations.front() == mybank::Violation::DOUBLED_TRANSACTION };
+
+            REQUIRE( doubled == expected );
+            if (violations.empty())
+            {
+                referenceTransactions.emplace(transaction.timeInMillis, transaction);
+            }
+        }
+    }
+}
@@ -0,0 +1,131 @@
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "../include/process_operations/process_operations.h"
+#include "../src/huge_page_arena.h"
+#include "generate_operations.h"
+
+namespace
+{
+
+auto mapped_bytes(const mybank::huge_page_usage &usage) -> std::size_t
+{
+    return usage.hugetlbfsBytes + usage.transparentBytes + usage.normalBytes;
+}
+
+auto aligned_to_huge_page(const void *address) -> bool
+{
+    return reinterpret_cast<uintptr_t>(address)%mybank::hugePageSize == 0;
+}
+
+} // namespace
+
+TEST_CASE( "Test huge page arena", "[huge_pages]" )
+{
+    SECTION( "with small allocations, then they share huge page aligned regions" )
+    {
+        mybank::HugePageResource resource{ mybank::HugePages::TRANSPARENT };
+
+        auto *first{ static_cast<char *>(resource.allocate(100, 8)) };
+        auto *second{ static_cast<char *>(resource.allocate(100, 64)) };
+
+        REQUIRE( aligned_to_huge_page(first) );
+        REQUIRE( second >= first + 100 );
+        REQUIRE( reinterpret_cast<uintptr_t>(second)%64 == 0 );
+        REQUIRE( mapped_bytes(resource.usage()) == mybank::hugePageSize );
+        REQUIRE( resource.usage().hugetlbfsBytes == 0 );
+
+        // Whole regions are mapped, so memory past the requested bytes is writable too
+        first[mybank::hugePageSize - 1] = 1;
+
+        auto *third{ resource.allocate(mybank::hugePageSize/4, 8) };
+        auto *fourth{ resource.allocate(mybank::hugePageSize/4, 8) };
+        auto *fifth{ resource.allocate(mybank::hugePageSize/4, 8) };
+        auto *sixth{ resource.allocate(mybank::hugePageSize/4, 8) };
+
+        REQUIRE( aligned_to_huge_page(sixth) );
+        REQUIRE( mapped_bytes(resource.usage()) == 2*mybank::hugePageSize );
+
+        resource.deallocate(third, mybank::hugePageSize/4, 8);
+        resource.deallocate(fourth, mybank::hugePageSize/4, 8);
+        resource.deallocate(fifth, mybank::hugePageSize/4, 8);
+
+        REQUIRE( mapped_bytes(resource.usage()) == 2*mybank::hugePageSize );
+    }
+
+    SECTION( "with large allocations, then each one has a region unmapped when deallocated" )
+    {
+        mybank::HugePageResource resource{ mybank::HugePages::HUGETLBFS };
+
+        auto *first{ resource.allocate(mybank::hugePageSize/2, 8) };
+        auto *second{ resource.allocate(3*mybank::hugePageSize + 1, 8) };
+
+        REQUIRE( aligned_to_huge_page(first) );
+        REQUIRE( aligned_to_huge_page(second) );
+        REQUIRE( mapped_bytes(resource.usage()) == 5*mybank::hugePageSize );
+
+        resource.deallocate(first, mybank::hugePageSize/2, 8);
+
+        REQUIRE( mapped_bytes(resource.usage()) == 4*mybank::hugePageSize );
+
+        resource.deallocate(second, 3*mybank::hugePageSize + 1, 8);
+
+        REQUIRE( mapped_bytes(resource.usage()) == 0 );
+    }
+
+    SECTION( "with huge pages for the history, then the output is the same as without" )
+    {
+        std::mt19937_64 random{ 20190213 };
+        const auto inputOperations{ mybank::test::generate_random_operations(random, 3000) };
+
+        std::istringstream input{ inputOperations };
+        std::ostringstream output;
+        mybank::process_operations(input, output);
+
+        for (const auto hugePages : { mybank::HugePages::TRANSPARENT, mybank::HugePages::HUGETLBFS })
+        {
+            mybank::process_options options{};
+            options.hugePages = hugePages;
+
+            std::istringstream hugePagesInput{ inputOperations };
+            std::ostringstream hugePagesOutput;
+            mybank::process_operations(hugePagesInput, hugePagesOutput, options);
+
+            REQUIRE( hugePagesOutput.str() == output.str() );
+        }
+    }
+
+    SECTION( "with state restored, released and moved, then the history outlives the arena" )
+    {
+        mybank::process_options options{};
+        options.hugePages = mybank::HugePages::TRANSPARENT;
+
+        mybank::transaction_history history{};
+        history.emplace(1550052000000, mybank::transaction{ 20, "Burger King", "2019-02-13T10:00:00.000Z", 1550052000000 });
+
+        // Move constructed, keeping the memory resource of the history returned
+        std::optional<mybank::authorizer_state> released{};
+        {
+            mybank::Authorizer authorizer{ options };
+            authorizer.restore({ true, 100 }, history);
+
+            mybank::Authorizer moved{ mybank::process_options{} };
+            moved = std::move(authorizer);
+            moved.process(R"({"transaction":{"merchant":"Habbib's","amount":30,"time":"2019-02-13T10:00:10.000Z"}})");
+
+            released.emplace(moved.release_state());
+            REQUIRE( moved.state().validTransactions.empty() );
+        }
+
+        REQUIRE( released->validTransactions.get_allocator().resource() == std::pmr::get_default_resource() );
+        REQUIRE( released->validTransactions.size() == 2 );
+        REQUIRE( released->validTransactions.rbegin()->second.merchant == "Habbib's" );
+        REQUIRE( released->account->availableLimit == 70 );
+    }
+}
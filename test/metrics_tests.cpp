@@ -0,0 +1,161 @@
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "../include/process_operations/metrics.h"
+#include "../include/process_operations/process_operations.h"
+#include "generate_operations.h"
+
+namespace
+{
+
+auto process_with_metrics(const std::string &inputOperations, mybank::process_options options) -> mybank::metrics_snapshot
+{
+    mybank::Metrics metrics{};
+    options.metrics = &metrics;
+
+    std::istringstream input{ inputOperations };
+    std::ostringstream output;
+    mybank::process_operations(input, output, options);
+
+    return metrics.snapshot();
+}
+
+} // namespace
+
+TEST_CASE( "Test metrics", "[metrics]" )
+{
+    SECTION( "with skipped, unknown and authorized operations, then each is counted" )
+    {
+        const std::string inputOperations{
+            "{\"transaction\":{\"merchant\":\"Burger King\",\"amount\":20,\"time\":\"2019-02-13T10:00:00.000Z\"}}\n"
+            "not json\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":100}}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":350}}\n"
+            "{\"deposit\":{\"amount\":20}}\n"
+            "{\"transaction\":{\"merchant\":\"Burger King\",\"amount\":20,\"time\":\"2019-02-13T10:00:00.000Z\"}}\n"
+            "{\"transaction\":{\"merchant\":\"Habbib's\",\"amount\":90,\"time\":\"2019-02-13T10:01:00.000Z\"}}\n"
+            "{\"transaction\":{\"merchant\":\"Habbib's\",\"amount\":20,\"time\":\"2019-02-13T10:01:00.000Z\"}}\n"
+            "{\"transaction\":{\"merchant\":\"Habbib's\",\"amount\":10,\"time\":\"2019-02-13T10:01:30.000Z\"}}\n"
+            "{\"transaction\":{\"merchant\":\"Habbib's\",\"amount\":5,\"time\":\"2019-02-13T10:01:45.000Z\"}}\n"
+        };
+
+        const auto snapshot{ process_with_metrics(inputOperations, {}) };
+
+        REQUIRE( snapshot[mybank::Metric::OPERATIONS] == 9 );
+        REQUIRE( snapshot[mybank::Metric::INVALID_LINES] == 1 );
+        REQUIRE( snapshot[mybank::Metric::UNKNOWN_OPERATIONS] == 1 );
+        REQUIRE( snapshot[mybank::Metric::ACCEPTED_TRANSACTIONS] == 3 );
+        REQUIRE( snapshot[mybank::Metric::HISTORY_TRANSACTIONS] == 0 );
+        REQUIRE( snapshot[mybank::Violation::ACCOUNT_ALREADY_INITIALIZED] == 1 );
+        REQUIRE( snapshot[mybank::Violation::INSUFFICIENT_LIMIT] == 1 );
+        REQUIRE( snapshot[mybank::Violation::HIGH_FREQUENCY_SMALL_INTERVAL] == 1 );
+        REQUIRE( snapshot[mybank::Violation::DOUBLED_TRANSACTION] == 0 );
+    }
+
+    SECTION( "with every execution mode, then the counts are the same" )
+    {
+        const auto inputOperations{ mybank::test::generate_operations(3000) };
+        const auto expected{ process_with_metrics(inputOperations, {}) };
+
+        REQUIRE( expected[mybank::Metric::ACCEPTED_TRANSACTIONS] > 0 );
+        REQUIRE( expected[mybank::Metric::INVALID_LINES] > 0 );
+
+        mybank::process_options pipelined{};
+        pipelined.pipelined = true;
+        mybank::process_options parallelDecode{};
+        parallelDecode.decodeThreads = 3;
+        parallelDecode.decodeChunkLines = 64;
+
+        for (const auto &options : { pipelined, parallelDecode })
+        {
+            const auto snapshot{ process_with_metrics(inputOperations, options) };
+            REQUIRE( snapshot.metrics == expected.metrics );
+            REQUIRE( snapshot.violations == expected.violations );
+        }
+
+        // Reordering changes which transactions are accepted, not which lines are decoded
+        mybank::process_options reordered{};
+        reordered.reorderLatenessMillis = 1000;
+        const auto snapshot{ process_with_metrics(inputOperations, reordered) };
+        REQUIRE( snapshot[mybank::Metric::OPERATIONS] == expected[mybank::Metric::OPERATIONS] );
+        REQUIRE( snapshot[mybank::Metric::INVALID_LINES] == expected[mybank::Metric::INVALID_LINES] );
+    }
+
+    SECTION( "with an authorizer keeping transactions, then the gauges follow it until it is destroyed" )
+    {
+        mybank::Metrics metrics{};
+        mybank::process_options options{};
+        options.metrics = &metrics;
+        options.rules.spendWindowMillis = 60*1000;
+
+        {
+            mybank::Authorizer authorizer{ options };
+            authorizer.restore({ true, 1000 }, { { 1550052000000, { 20, "Burger King", "2019-02-13T10:00:00.000Z", 1550052000000 } } });
+            REQUIRE( metrics.snapshot()[mybank::Metric::HISTORY_TRANSACTIONS] == 1 );
+            REQUIRE( metrics.snapshot()[mybank::Metric::SPEND_WINDOW_TRANSACTIONS] == 1 );
+
+            authorizer.process(mybank::transaction{ 30, "Habbib's", "2019-02-13T10:05:00.000Z", 1550052300000 });
+            authorizer.process(mybank::transaction{ 40, "Habbib's", "2019-02-13T10:05:10.000Z", 1550052310000 });
+
+            const auto snapshot{ metrics.snapshot() };
+            REQUIRE( snapshot[mybank::Metric::HISTORY_TRANSACTIONS] == 3 );
+            REQUIRE( snapshot[mybank::Metric::SPEND_WINDOW_TRANSACTIONS] == 2 );
+            REQUIRE( snapshot[mybank::Metric::SPEND_WINDOW_EVICTIONS] == 1 );
+
+            auto moved{ std::move(authorizer) };
+            REQUIRE( metrics.snapshot()[mybank::Metric::HISTORY_TRANSACTIONS] == 3 );
+        }
+
+        REQUIRE( metrics.snapshot()[mybank::Metric::HISTORY_TRANSACTIONS] == 0 );
+        REQUIRE( metrics.snapshot()[mybank::Metric::SPEND_WINDOW_TRANSACTIONS] == 0 );
+        REQUIRE( metrics.snapshot()[mybank::Metric::SPEND_WINDOW_EVICTIONS] == 1 );
+    }
+
+    SECTION( "with many threads adding, then the snapshot sums all of them" )
+    {
+        mybank::Metrics metrics{};
+        std::vector<std::thread> threads{};
+        for (auto i{ 0 }; i < 24; ++i)
+        {
+            threads.emplace_back([&metrics]() {
+                for (auto j{ 0 }; j < 1000; ++j)
+                {
+                    metrics.add(mybank::Metric::OPERATIONS);
+                    metrics.add(mybank::Violation::DOUBLED_TRANSACTION);
+                }
+            });
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        REQUIRE( metrics.snapshot()[mybank::Metric::OPERATIONS] == 24000 );
+        REQUIRE( metrics.snapshot()[mybank::Violation::DOUBLED_TRANSACTION] == 24000 );
+    }
+
+    SECTION( "with a snapshot, then the Prometheus text has every metric and violation" )
+    {
+        mybank::Metrics metrics{};
+        metrics.add(mybank::Metric::INVALID_LINES, 3);
+        metrics.add(mybank::Violation::INSUFFICIENT_LIMIT);
+
+        const auto text{ mybank::to_prometheus(metrics.snapshot()) };
+        REQUIRE( text.find("# TYPE mybank_invalid_lines_total counter\nmybank_invalid_lines_total 3\n") != std::string::npos );
+        REQUIRE( text.find("# TYPE mybank_history_transactions gauge\n") != std::string::npos );
+        REQUIRE( text.find("mybank_violations_total{violation=\"insufficient-limit\"} 1\n") != std::string::npos );
+        REQUIRE( text.find("mybank_violations_total{violation=\"velocity-count-limit\"} 0\n") != std::string::npos );
+
+        const std::string path{ "metrics_tests.prom" };
+        REQUIRE( mybank::write_prometheus(metrics, path) );
+        std::ifstream file{ path };
+        REQUIRE( std::string{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} } == text );
+        std::remove(path.c_str());
+    }
+}
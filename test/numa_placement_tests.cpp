@@ -0,0 +1,129 @@
+#include <sstream>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "../include/process_operations/process_operations.h"
+#include "../include/process_operations/metrics.h"
+#include "../include/process_operations/numa_topology.h"
+#include "../src/numa_placement.h"
+#include "generate_operations.h"
+
+TEST_CASE( "Test NUMA topology and placement", "[numa]" )
+{
+    SECTION( "with kernel CPU lists, then they are expanded, and malformed ones rejected" )
+    {
+        REQUIRE( mybank::parse_cpu_list("0-3,8,10-11\n") == std::vector<int>{ 0, 1, 2, 3, 8, 10, 11 } );
+        REQUIRE( mybank::parse_cpu_list("5") == std::vector<int>{ 5 } );
+        REQUIRE( mybank::parse_cpu_list("\n") == std::vector<int>{} );
+
+        REQUIRE( !mybank::parse_cpu_list("3-1").has_value() );
+        REQUIRE( !mybank::parse_cpu_list("1,").has_value() );
+        REQUIRE( !mybank::parse_cpu_list("1--2").has_value() );
+        REQUIRE( !mybank::parse_cpu_list("-1").has_value() );
+        REQUIRE( !mybank::parse_cpu_list("0-3;4").has_value() );
+    }
+
+    SECTION( "with the machine's topology, then every node has CPUs" )
+    {
+        const auto topology{ mybank::detect_numa_topology() };
+
+        REQUIRE( !topology.nodeCpus.empty() );
+        for (const auto &cpus : topology.nodeCpus)
+        {
+            REQUIRE( !cpus.empty() );
+        }
+        REQUIRE( mybank::current_numa_node(topology) < topology.nodeCpus.size() );
+        REQUIRE( topology.nodeIds.size() <= topology.nodeCpus.size() );
+
+        // Known only when the kernel numbers the nodes and answers for the page
+        const int allocated{ 0 };
+        const auto node{ mybank::memory_numa_node(topology, &allocated) };
+        REQUIRE( (!node.has_value() || node.value() < topology.nodeCpus.size()) );
+        REQUIRE( !mybank::memory_numa_node(mybank::numa_topology{ topology.nodeCpus }, &allocated).has_value() );
+    }
+
+    SECTION( "with decoders fitting in the CPUs, then the committer's node is filled first" )
+    {
+        const mybank::numa_topology topology{ { { 0, 1, 2, 3 }, { 4, 5, 6, 7 } } };
+
+        const auto fromFirst{ mybank::plan_numa_placement(topology, 0, 5) };
+        REQUIRE( fromFirst.committerNode == 0 );
+        REQUIRE( fromFirst.decoderNodes == std::vector<std::size_t>{ 0, 0, 1, 1, 1 } );
+        REQUIRE( fromFirst.readerCpus == std::vector<int>{ 0, 1 } );
+
+        const auto fromSecond{ mybank::plan_numa_placement(topology, 1, 5) };
+        REQUIRE( fromSecond.committerNode == 1 );
+        REQUIRE( fromSecond.decoderNodes == std::vector<std::size_t>{ 1, 1, 0, 0, 0 } );
+        REQUIRE( fromSecond.readerCpus == std::vector<int>{ 4, 5 } );
+
+        const mybank::numa_topology single{ { { 3 } } };
+        REQUIRE( mybank::plan_numa_placement(single, 0, 1).readerCpus == std::vector<int>{ 3 } );
+    }
+
+    SECTION( "with more decoders than CPUs, then the rest go round robin from the committer's node" )
+    {
+        const mybank::numa_topology topology{ { { 0, 1 }, { 2, 3 } } };
+
+        const auto placement{ mybank::plan_numa_placement(topology, 0, 5) };
+        REQUIRE( placement.decoderNodes == std::vector<std::size_t>{ 1, 1, 0, 1, 0 } );
+
+        // A committer node past the topology is its last node
+        REQUIRE( mybank::plan_numa_placement(topology, 7, 1).committerNode == 1 );
+    }
+
+    SECTION( "with a CPU in no node, then the current node is the first one" )
+    {
+        const mybank::numa_topology topology{ { { 100000 }, { 100001 } } };
+
+        REQUIRE( mybank::current_numa_node(topology) == 0 );
+        REQUIRE( !mybank::pin_current_thread({}) );
+    }
+
+    SECTION( "with simulated topologies, then output is the same as the sequential mode" )
+    {
+        const auto inputOperations{ mybank::test::generate_operations(2000) };
+
+        std::istringstream input{ inputOperations };
+        std::ostringstream output;
+        mybank::process_operations(input, output);
+
+        // The machine's CPUs split in two nodes, then CPUs the system refuses to pin threads to
+        const auto machine{ mybank::detect_numa_topology() };
+        std::vector<int> cpus{};
+        for (const auto &nodeCpus : machine.nodeCpus)
+        {
+            cpus.insert(cpus.end(), nodeCpus.begin(), nodeCpus.end());
+        }
+        const auto half{ (cpus.size() + 1)/2 };
+        const mybank::numa_topology split{ {
+            std::vector<int>(cpus.begin(), cpus.begin() + half),
+            (cpus.size() > 1) ? std::vector<int>(cpus.begin() + half, cpus.end()) : cpus
+        } };
+        const mybank::numa_topology refused{ { { 100000, 100001 }, { 100002 }, { 100003 } } };
+        const auto callerCpus{ mybank::current_thread_cpus() };
+
+        for (const auto *topology : { &split, &refused })
+        {
+            mybank::Metrics metrics{};
+            mybank::process_options options{};
+            options.decodeThreads = 5;
+            options.decodeChunkLines = 7;
+            options.numaTopology = topology;
+            options.metrics = &metrics;
+
+            std::istringstream numaInput{ inputOperations };
+            std::ostringstream numaOutput;
+            mybank::process_operations(numaInput, numaOutput, options);
+
+            REQUIRE( numaOutput.str() == output.str() );
+            REQUIRE( mybank::current_thread_cpus() == callerCpus );
+
+            // The decoders, the committer and the reading thread
+            if (topology == &refused)
+            {
+                REQUIRE( metrics.snapshot()[mybank::Metric::UNPINNED_THREADS] == 7 );
+            }
+        }
+    }
+}
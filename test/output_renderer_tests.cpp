@@ -0,0 +1,45 @@
+#include <string>
+
+#include "catch.hpp"
+
+#include "../src/output_renderer.h"
+
+TEST_CASE( "Test output renderer", "[output]" )
+{
+    SECTION( "with every violation mask and changing accounts, then the lines are the serialized account and violations" )
+    {
+        const mybank::account accounts[]{ { true, 100 }, { true, 100 }, { false, 100 }, { false, -20 }, { true, 0 } };
+        mybank::OutputRenderer renderer{ false };
+
+        for (const auto &account : accounts)
+        {
+            for (unsigned mask{ 0 }; mask < (1u << mybank::violationCount); ++mask)
+            {
+                const auto violations{ mybank::to_violations(static_cast<mybank::violation_mask>(mask)) };
+                const auto expected{ json{ { "account", account }, { "violations", violations } }.dump() + '\n' };
+
+                std::string output{ "previous\n" };
+                renderer.append(output, 1, mybank::OperationType::TRANSACTION, account, violations);
+                REQUIRE( output == "previous\n" + expected );
+            }
+        }
+    }
+
+    SECTION( "with delta output, then only changes are rendered" )
+    {
+        mybank::OutputRenderer renderer{ true };
+        std::string output{};
+
+        renderer.append(output, 3, mybank::OperationType::UNKNOWN, { true, 100 }, mybank::violation_mask{ 0 });
+        REQUIRE( output.empty() );
+
+        renderer.append(output, 4, mybank::OperationType::ACCOUNT, { false, 100 }, mybank::violation_mask{ 0 });
+        renderer.append(output, 5, mybank::OperationType::TRANSACTION, { false, 100 },
+                        std::vector<mybank::Violation>{ mybank::Violation::ACCOUNT_NOT_ACTIVE, mybank::Violation::INSUFFICIENT_LIMIT });
+        renderer.append(output, 6, mybank::OperationType::TRANSACTION, { true, -5 }, mybank::violation_mask{ 0 });
+        REQUIRE( output ==
+                 "{\"seq\":4,\"account\":{\"activeAccount\":false,\"availableLimit\":100}}\n"
+                 "{\"seq\":5,\"violations\":[\"account-not-active\",\"insufficient-limit\"]}\n"
+                 "{\"seq\":6,\"availableLimit\":-5}\n" );
+    }
+}
@@ -0,0 +1,55 @@
+#include <sstream>
+
+#include "catch.hpp"
+
+#include "../include/process_operations/process_operations.h"
+#include "generate_operations.h"
+
+TEST_CASE( "Test process_operations with parallel decoding", "[parallel_decode]" )
+{
+    const auto inputOperations{ mybank::test::generate_operations(2000) };
+
+    std::istringstream input{ inputOperations };
+    std::ostringstream output;
+    mybank::process_operations(input, output);
+
+    SECTION( "with several decoder threads and small chunks, then output is the same as the sequential mode" )
+    {
+        mybank::process_options options{};
+        options.decodeThreads = 4;
+        options.decodeChunkLines = 7;
+
+        std::istringstream parallelInput{ inputOperations };
+        std::ostringstream parallelOutput;
+        mybank::process_operations(parallelInput, parallelOutput, options);
+
+        REQUIRE( parallelOutput.str() == output.str() );
+    }
+
+    SECTION( "with a single decoder thread and a chunk bigger than the input, then output is the same as the sequential mode" )
+    {
+        mybank::process_options options{};
+        options.decodeThreads = 1;
+        options.decodeChunkLines = 100000;
+
+        std::istringstream parallelInput{ inputOperations };
+        std::ostringstream parallelOutput;
+        mybank::process_operations(parallelInput, parallelOutput, options);
+
+        REQUIRE( parallelOutput.str() == output.str() );
+    }
+
+    SECTION( "with empty input, then nothing is written" )
+    {
+        mybank::account account{ true, 100 };
+        mybank::transaction_history validTransactions{};
+        mybank::process_options options{};
+        options.decodeThreads = 2;
+
+        std::istringstream emptyInput{};
+        std::ostringstream emptyOutput;
+        mybank::process_transactions(account, validTransactions, emptyInput, emptyOutput, options);
+
+        REQUIRE( emptyOutput.str().empty() );
+    }
+}
@@ -0,0 +1,127 @@
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <mutex>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+
+#include "catch.hpp"
+
+#include "../include/process_operations/process_operations.h"
+#include "generate_operations.h"
+
+namespace
+{
+
+// Serves the first part of the input, then blocks like an idle stream until released
+class StallingStreambuf : public std::streambuf
+{
+public:
+    StallingStreambuf(std::string first, std::string rest)
+            : first_{ std::move(first) },
+              rest_{ std::move(rest) }
+    {
+    }
+
+    void release()
+    {
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+            released_ = true;
+        }
+        releasedChanged_.notify_one();
+    }
+
+protected:
+    auto underflow() -> int_type override
+    {
+        if (served_ == 0)
+        {
+            served_ = 1;
+            setg(first_.data(), first_.data(), first_.data() + first_.size());
+            return traits_type::to_int_type(first_.front());
+        }
+
+        if (served_ == 1)
+        {
+            std::unique_lock<std::mutex> lock{ mutex_ };
+            releasedChanged_.wait(lock, [&]() { return released_; });
+
+            served_ = 2;
+            setg(rest_.data(), rest_.data(), rest_.data() + rest_.size());
+            return traits_type::to_int_type(rest_.front());
+        }
+
+        return traits_type::eof();
+    }
+
+private:
+    std::string first_;
+    std::string rest_;
+    int served_{ 0 };
+    std::mutex mutex_{};
+    std::condition_variable releasedChanged_{};
+    bool released_{ false };
+};
+
+} // namespace
+
+TEST_CASE( "Test process_operations in pipelined mode", "[pipeline]" )
+{
+    const auto inputOperations{ mybank::test::generate_operations(2000) };
+
+    std::istringstream input{ inputOperations };
+    std::ostringstream output;
+    mybank::process_operations(input, output);
+
+    SECTION( "with default ring capacity, then output is the same as the sequential mode" )
+    {
+        mybank::process_options options{};
+        options.pipelined = true;
+
+        std::istringstream pipelinedInput{ inputOperations };
+        std::ostringstream pipelinedOutput;
+        mybank::process_operations(pipelinedInput, pipelinedOutput, options);
+
+        REQUIRE( pipelinedOutput.str() == output.str() );
+    }
+
+    SECTION( "with single entry rings, then backpressure keeps the output unchanged" )
+    {
+        mybank::process_options options{};
+        options.pipelined = true;
+        options.pipelineCapacity = 1;
+
+        std::istringstream pipelinedInput{ inputOperations };
+        std::ostringstream pipelinedOutput;
+        mybank::process_operations(pipelinedInput, pipelinedOutput, options);
+
+        REQUIRE( pipelinedOutput.str() == output.str() );
+    }
+
+    SECTION( "with an input stream stalling, then the pipeline threads sleep instead of spinning" )
+    {
+        const auto split{ inputOperations.find('\n', inputOperations.size()/2) + 1 };
+        StallingStreambuf stalling{ inputOperations.substr(0, split), inputOperations.substr(split) };
+        std::istream stallingInput{ &stalling };
+        std::ostringstream pipelinedOutput;
+
+        mybank::process_options options{};
+        options.pipelined = true;
+        std::thread pipeline{ [&]() { mybank::process_operations(stallingInput, pipelinedOutput, options); } };
+
+        // Once the first part went through, only the spinning of the waiting threads would use CPU time
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 100 });
+        const auto idleStart{ std::clock() };
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 300 });
+        const auto idleSeconds{ static_cast<double>(std::clock() - idleStart)/CLOCKS_PER_SEC };
+
+        stalling.release();
+        pipeline.join();
+
+        REQUIRE( idleSeconds < 0.05 );
+        REQUIRE( pipelinedOutput.str() == output.str() );
+    }
+}
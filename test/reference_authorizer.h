@@ -0,0 +1,201 @@
+#ifndef PROCESS_OPERATIONS_TEST_REFERENCE_AUTHORIZER_H
+#define PROCESS_OPERATIONS_TEST_REFERENCE_AUTHORIZER_H
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+// Frozen copy of the sequential implementation with the default rules, only built on nlohmann::json,
+// strptime/mktime and the history scan. Optimized paths must write byte-identical output.
+// Do not change it along with the library, except for intended changes of behaviour.
+namespace mybank::test::reference
+{
+
+using json = nlohmann::json;
+
+struct transaction
+{
+    int64_t amount;
+    std::string merchant;
+    time_t timeInMillis;
+};
+
+inline auto iso8601_to_millis(const std::string &timeIso8601) -> time_t
+{
+    tm time{};
+    memset(&time, 0, sizeof(tm));
+    strptime(timeIso8601.c_str(), "%Y-%m-%dT%H:%M:%SZ", &time);
+    const auto milliseconds{ (timeIso8601.length() > 20) ? std::strtol(&timeIso8601[20], nullptr, 10) : 0 };
+    return mktime(&time)*1000 + milliseconds;
+}
+
+inline auto is_valid_json_account(const json &j) -> bool
+{
+    return (j.is_object() &&
+            j.find("account") != j.end() &&
+            j["account"].find("activeAccount") != j["account"].end() &&
+            j["account"]["activeAccount"].is_boolean() &&
+            j["account"].find("availableLimit") != j["account"].end() &&
+            j["account"]["availableLimit"].is_number_integer());
+}
+
+// Mistyped merchant or time make an unknown operation, not an error
+inline auto is_valid_json_transaction(const json &j) -> bool
+{
+    return (j.is_object() &&
+            j.find("transaction") != j.end() &&
+            j["transaction"].find("merchant") != j["transaction"].end() &&
+            j["transaction"]["merchant"].is_string() &&
+            j["transaction"].find("amount") != j["transaction"].end() &&
+            j["transaction"]["amount"].is_number_integer() &&
+            j["transaction"].find("time") != j["transaction"].end() &&
+            j["transaction"]["time"].is_string());
+}
+
+inline auto render(bool activeAccount, int64_t availableLimit, const std::vector<std::string> &violations) -> std::string
+{
+    return json{
+        { "account", { { "activeAccount", activeAccount }, { "availableLimit", availableLimit } } },
+        { "violations", violations }
+    }.dump() + '\n';
+}
+
+inline void validate_transactions_small_interval(
+        const std::map<time_t, transaction> &validTransactions,
+        const transaction &transaction,
+        std::vector<std::string> &violations)
+{
+    constexpr auto smallInterval{ 2*60*1000 };
+
+    double timediff;
+    auto maxTransactionsSmallInterval{ 0 };
+    auto maxEqualTransactionsSmallInterval{ 0 };
+    std::deque<reference::transaction> transactionsSmallInterval{};
+    for (auto crit{ validTransactions.crbegin() };
+         crit != validTransactions.crend() &&
+         (timediff = difftime(transaction.timeInMillis, crit->first)) < smallInterval;
+         ++crit)
+    {
+        if (fabs(timediff) < smallInterval)
+        {
+            transactionsSmallInterval.push_back(crit->second);
+            while (difftime(transactionsSmallInterval.front().timeInMillis, crit->first) > smallInterval)
+            {
+                transactionsSmallInterval.pop_front();
+            }
+
+            auto currTransactionsSmallInterval{ 0 };
+            auto currEqualTransactionsSmallInterval{ 0 };
+            for (const auto &t : transactionsSmallInterval)
+            {
+                ++currTransactionsSmallInterval;
+
+                if (t.merchant == transaction.merchant && t.amount == transaction.amount)
+                {
+                    ++currEqualTransactionsSmallInterval;
+                }
+            }
+
+            if (currTransactionsSmallInterval > maxTransactionsSmallInterval)
+            {
+                maxTransactionsSmallInterval = currTransactionsSmallInterval;
+            }
+
+            if (currEqualTransactionsSmallInterval > maxEqualTransactionsSmallInterval)
+            {
+                maxEqualTransactionsSmallInterval = currEqualTransactionsSmallInterval;
+            }
+        }
+    }
+
+    if (maxEqualTransactionsSmallInterval > 1)
+    {
+        violations.emplace_back("doubled-transaction");
+    }
+
+    if (maxTransactionsSmallInterval > 2)
+    {
+        violations.emplace_back("high-frequency-small-interval");
+    }
+}
+
+inline auto process_operations(const std::string &inputOperations) -> std::string
+{
+    std::istringstream in{ inputOperations };
+    std::string output{};
+
+    bool accountCreated{ false };
+    bool activeAccount{ false };
+    int64_t availableLimit{ 0 };
+    std::map<time_t, transaction> validTransactions{};
+
+    for (std::string inputLine; std::getline(in, inputLine);)
+    {
+        const auto inputJson = json::parse(inputLine, nullptr, false);
+        if (inputJson.is_discarded())
+        {
+            continue;
+        }
+
+        if (!accountCreated)
+        {
+            if (is_valid_json_account(inputJson))
+            {
+                accountCreated = true;
+                activeAccount = inputJson["account"]["activeAccount"].get<bool>();
+                availableLimit = inputJson["account"]["availableLimit"].get<int64_t>();
+                output += render(activeAccount, availableLimit, {});
+            }
+            continue;
+        }
+
+        std::vector<std::string> violations{};
+
+        if (is_valid_json_account(inputJson))
+        {
+            violations.emplace_back("account-already-initialized");
+        }
+        else if (is_valid_json_transaction(inputJson))
+        {
+            const auto &transactionJson{ inputJson["transaction"] };
+            const transaction transaction{
+                transactionJson["amount"].get<int64_t>(),
+                transactionJson["merchant"].get<std::string>(),
+                iso8601_to_millis(transactionJson["time"].get<std::string>()) };
+
+            if (!activeAccount)
+            {
+                violations.emplace_back("account-not-active");
+            }
+
+            if (availableLimit < transaction.amount)
+            {
+                violations.emplace_back("insufficient-limit");
+            }
+
+            validate_transactions_small_interval(validTransactions, transaction, violations);
+
+            if (violations.empty())
+            {
+                availableLimit -= transaction.amount;
+                validTransactions.emplace(transaction.timeInMillis, transaction);
+            }
+        }
+
+        output += render(activeAccount, availableLimit, violations);
+    }
+
+    return output;
+}
+
+} // namespace mybank::test::reference
+
+#endif // PROCESS_OPERATIONS_TEST_REFERENCE_AUTHORIZER_H
@@ -0,0 +1,119 @@
+#include <limits>
+#include <sstream>
+
+#include "catch.hpp"
+
+#include "../include/process_operations/process_operations.h"
+
+TEST_CASE( "Test process_transactions with reorder buffer", "[reorder_buffer]" )
+{
+    SECTION( "with ordered transactions, then output is the same as without reordering" )
+    {
+        constexpr auto inputOrderedTransactions{
+            R"({"transaction":{"merchant":"Burger King","amount":50,"time":"2019-02-13T10:00:00.000Z"}}
+               {"account":{"activeAccount":true,"availableLimit":100}}
+               {"transaction":{"merchant":"Burger King","amount":50,"time":"2019-02-13T10:01:00.000Z"}}
+               {"transaction":{"merchant":"Burger King","amount":50,"time":"2019-02-13T10:01:57.000Z"}}
+               {"transaction":{"merchant":"Burger King","amount":100,"time":"2019-02-13T10:01:58.911Z"}}
+               {"transaction":{"merchant":"Burger King","amount":100,"time":"2019-02-13T10:02:30.000Z"}})"
+        };
+
+        mybank::account account{ true, 1000 };
+        std::istringstream input{ inputOrderedTransactions };
+        std::ostringstream output;
+        mybank::process_transactions(account, input, output);
+
+        mybank::account reorderedAccount{ true, 1000 };
+        mybank::transaction_history validTransactions{};
+        std::istringstream reorderedInput{ inputOrderedTransactions };
+        std::ostringstream reorderedOutput;
+        mybank::process_transactions(reorderedAccount, validTransactions, reorderedInput, reorderedOutput, { nullptr, 60*1000, 16 });
+
+        REQUIRE( reorderedAccount.availableLimit == account.availableLimit );
+        REQUIRE( reorderedOutput.str() == output.str() );
+    }
+
+    SECTION( "with unordered transactions, then they are decided in time order and output in arrival order" )
+    {
+        constexpr auto inputUnorderedTransactions{
+            R"({"transaction":{"merchant":"Burger King","amount":20,"time":"2019-02-13T10:00:00.000Z"}}
+               {"transaction":{"merchant":"Burger King","amount":30,"time":"2019-02-13T10:01:00.000Z"}}
+               {"transaction":{"merchant":"Burger King","amount":30,"time":"2019-02-13T10:01:55.000Z"}}
+               {"transaction":{"merchant":"Burger King","amount":20,"time":"2019-02-13T10:01:30.000Z"}}
+               {"transaction":{"merchant":"Burger King","amount":20,"time":"2019-02-13T09:59:55.001Z"}})"
+        };
+        constexpr auto outputReorderedTransactions{
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":60},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":30},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":30},\"violations\":[\"high-frequency-small-interval\"]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":30},\"violations\":[\"doubled-transaction\",\"high-frequency-small-interval\"]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":80},\"violations\":[]}\n"
+        };
+
+        mybank::account account{ true, 100 };
+        mybank::transaction_history validTransactions{};
+
+        std::istringstream input{ inputUnorderedTransactions };
+        std::ostringstream output;
+
+        mybank::process_transactions(account, validTransactions, input, output, { nullptr, 10*60*1000, 16 });
+
+        REQUIRE( account.availableLimit == 30 );
+        REQUIRE( validTransactions.size() == 3 );
+        REQUIRE( output.str() == outputReorderedTransactions );
+    }
+
+    SECTION( "with a lateness past maxWindowMillis before 1970, then it is clamped and transactions are still held" )
+    {
+        constexpr auto inputUnorderedTransactions{
+            R"({"transaction":{"merchant":"Burger King","amount":20,"time":"1969-02-13T10:00:00.000Z"}}
+               {"transaction":{"merchant":"Burger King","amount":30,"time":"1969-02-13T10:01:00.000Z"}}
+               {"transaction":{"merchant":"Burger King","amount":30,"time":"1969-02-13T10:01:55.000Z"}}
+               {"transaction":{"merchant":"Burger King","amount":20,"time":"1969-02-13T10:01:30.000Z"}}
+               {"transaction":{"merchant":"Burger King","amount":20,"time":"1969-02-13T09:59:55.001Z"}})"
+        };
+        constexpr auto outputReorderedTransactions{
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":60},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":30},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":30},\"violations\":[\"high-frequency-small-interval\"]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":30},\"violations\":[\"doubled-transaction\",\"high-frequency-small-interval\"]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":80},\"violations\":[]}\n"
+        };
+
+        mybank::account account{ true, 100 };
+        mybank::transaction_history validTransactions{};
+
+        std::istringstream input{ inputUnorderedTransactions };
+        std::ostringstream output;
+
+        mybank::process_transactions(account, validTransactions, input, output, { nullptr, std::numeric_limits<time_t>::max(), 16 });
+
+        REQUIRE( account.availableLimit == 30 );
+        REQUIRE( output.str() == outputReorderedTransactions );
+    }
+
+    SECTION( "with capacity exceeded, then the oldest transaction is released early" )
+    {
+        constexpr auto inputTransactions{
+            R"({"transaction":{"merchant":"Burger King","amount":10,"time":"2019-02-13T10:00:10.000Z"}}
+               {"transaction":{"merchant":"Burger King","amount":20,"time":"2019-02-13T10:00:00.000Z"}}
+               {"transaction":{"merchant":"Burger King","amount":30,"time":"2019-02-13T09:00:00.000Z"}})"
+        };
+        constexpr auto outputTransactions{
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":40},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":80},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":50},\"violations\":[]}\n"
+        };
+
+        mybank::account account{ true, 100 };
+        mybank::transaction_history validTransactions{};
+
+        std::istringstream input{ inputTransactions };
+        std::ostringstream output;
+
+        mybank::process_transactions(account, validTransactions, input, output, { nullptr, 10*60*1000, 1 });
+
+        REQUIRE( account.availableLimit == 40 );
+        REQUIRE( output.str() == outputTransactions );
+    }
+}
@@ -0,0 +1,204 @@
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "catch.hpp"
+
+#include "../include/process_operations/process_operations.h"
+
+namespace
+{
+
+auto temporary_path(const std::string &name) -> std::string
+{
+    const auto path{ std::filesystem::temp_directory_path() / ("mybank_" + name) };
+    std::filesystem::remove(path);
+    return path.string();
+}
+
+auto write_file(const std::string &name, const std::string &content) -> std::string
+{
+    const auto path{ temporary_path(name) };
+    std::ofstream{ path } << content;
+    return path;
+}
+
+// The history scan of the interval rules, with the rule options as parameters
+auto reference_violations(
+        const mybank::rule_options &rules,
+        const mybank::transaction_history &validTransactions,
+        const mybank::transaction &transaction)
+        -> std::vector<mybank::Violation>
+{
+    std::size_t maxTransactions{ 0 };
+    std::size_t maxEqualTransactions{ 0 };
+    std::deque<mybank::transaction> window{};
+    for (auto crit{ validTransactions.crbegin() };
+         crit != validTransactions.crend() && transaction.timeInMillis - crit->first < rules.smallIntervalMillis;
+         ++crit)
+    {
+        if (crit->first - transaction.timeInMillis < rules.smallIntervalMillis)
+        {
+            window.push_back(crit->second);
+            while (window.front().timeInMillis - crit->first > rules.smallIntervalMillis)
+            {
+                window.pop_front();
+            }
+
+            std::size_t equalTransactions{ 0 };
+            for (const auto &t : window)
+            {
+                equalTransactions += (t.merchant == transaction.merchant && t.amount == transaction.amount) ? 1 : 0;
+            }
+
+            maxTransactions = std::max(maxTransactions, window.size());
+            maxEqualTransactions = std::max(maxEqualTransactions, equalTransactions);
+        }
+    }
+
+    std::vector<mybank::Violation> violations{};
+    if (maxEqualTransactions > rules.maxEqualTransactionsSmallInterval)
+    {
+        violations.push_back(mybank::Violation::DOUBLED_TRANSACTION);
+    }
+    if (maxTransactions > rules.maxTransactionsSmallInterval)
+    {
+        violations.push_back(mybank::Violation::HIGH_FREQUENCY_SMALL_INTERVAL);
+    }
+    return violations;
+}
+
+} // namespace
+
+TEST_CASE( "Test load_rule_options", "[rule_options]" )
+{
+    SECTION( "with some rule options in the file, then the others keep their defaults" )
+    {
+        const auto path{ write_file("rules.json", R"({"smallIntervalMillis":60000,"maxTransactionsSmallInterval":5})") };
+
+        const auto rules{ mybank::load_rule_options(path) };
+
+        REQUIRE( rules.has_value() );
+        REQUIRE( rules->smallIntervalMillis == 60000 );
+        REQUIRE( rules->maxTransactionsSmallInterval == 5 );
+        REQUIRE( rules->maxEqualTransactionsSmallInterval == 1 );
+    }
+
+    SECTION( "with a missing file, invalid JSON, unknown keys or negative values, then std::nullopt is returned" )
+    {
+        REQUIRE( !mybank::load_rule_options(temporary_path("missing_rules.json")).has_value() );
+        REQUIRE( !mybank::load_rule_options(write_file("rules.json", R"({"smallIntervalMillis":)")).has_value() );
+        REQUIRE( !mybank::load_rule_options(write_file("rules.json", R"({"smallInterval":60000})")).has_value() );
+        REQUIRE( !mybank::load_rule_options(write_file("rules.json", R"({"maxTransactionsSmallInterval":-1})")).has_value() );
+    }
+
+    SECTION( "with windows past maxWindowMillis, then std::nullopt is returned" )
+    {
+        const auto window = [](const char *key, const std::string &millis) {
+            return mybank::load_rule_options(write_file("rules.json", "{\"" + std::string{ key } + "\":" + millis + "}"));
+        };
+        const auto maxWindow{ std::to_string(mybank::maxWindowMillis) };
+        const auto pastMaxWindow{ std::to_string(mybank::maxWindowMillis + 1) };
+
+        REQUIRE( window("smallIntervalMillis", maxWindow)->smallIntervalMillis == mybank::maxWindowMillis );
+        REQUIRE( window("spendWindowMillis", maxWindow)->spendWindowMillis == mybank::maxWindowMillis );
+        REQUIRE( !window("smallIntervalMillis", pastMaxWindow).has_value() );
+        REQUIRE( !window("spendWindowMillis", pastMaxWindow).has_value() );
+        REQUIRE( !window("smallIntervalMillis", "9223372036854775807").has_value() );
+        REQUIRE( !window("spendWindowMillis", "18446744073709551615").has_value() );
+    }
+}
+
+TEST_CASE( "Test process_operations with rule options", "[rule_options]" )
+{
+    SECTION( "with a higher frequency threshold, then 4 transactions in 2 minutes are accepted" )
+    {
+        constexpr auto inputTransactions{
+            R"({"account":{"activeAccount":true,"availableLimit":100}}
+               {"transaction":{"merchant":"Burger King","amount":10,"time":"2019-02-13T10:00:00.000Z"}}
+               {"transaction":{"merchant":"Habbib's","amount":10,"time":"2019-02-13T10:00:30.000Z"}}
+               {"transaction":{"merchant":"McDonald's","amount":10,"time":"2019-02-13T10:01:00.000Z"}}
+               {"transaction":{"merchant":"Subway","amount":10,"time":"2019-02-13T10:01:30.000Z"}}
+               {"transaction":{"merchant":"Pizza Hut","amount":10,"time":"2019-02-13T10:01:45.000Z"}})"
+        };
+        constexpr auto outputTransactions{
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":100},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":90},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":80},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":70},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":60},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":60},\"violations\":[\"high-frequency-small-interval\"]}\n"
+        };
+
+        mybank::process_options options{};
+        options.rules.maxTransactionsSmallInterval = 3;
+
+        std::istringstream input{ inputTransactions };
+        std::ostringstream output;
+        mybank::process_operations(input, output, options);
+
+        REQUIRE( output.str() == outputTransactions );
+    }
+
+    SECTION( "with windows set past maxWindowMillis in code, then they are clamped to it" )
+    {
+        constexpr auto inputTransactions{
+            R"({"account":{"activeAccount":true,"availableLimit":100}}
+               {"transaction":{"merchant":"Burger King","amount":10,"time":"2019-02-13T10:00:00.000Z"}}
+               {"transaction":{"merchant":"Habbib's","amount":10,"time":"3029-02-13T10:00:00.000Z"}}
+               {"transaction":{"merchant":"McDonald's","amount":10,"time":"3929-02-13T10:00:00.000Z"}})"
+        };
+        constexpr auto outputTransactions{
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":100},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":90},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":80},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":80},\"violations\":[\"spend-velocity\",\"high-frequency-small-interval\"]}\n"
+        };
+
+        mybank::process_options options{};
+        options.rules.smallIntervalMillis = std::numeric_limits<time_t>::max();
+        options.rules.maxTransactionsSmallInterval = 0;
+        options.rules.spendWindowMillis = std::numeric_limits<time_t>::max();
+        options.rules.maxSpendInWindow = 15;
+
+        std::istringstream input{ inputTransactions };
+        std::ostringstream output;
+        mybank::process_operations(input, output, options);
+
+        REQUIRE( output.str() == outputTransactions );
+    }
+
+    SECTION( "with random rule options, then violations match the history scan with the same parameters" )
+    {
+        std::mt19937_64 random{ 20190213 };
+
+        for (auto run{ 0 }; run < 40; ++run)
+        {
+            mybank::process_options options{};
+            options.rules = { static_cast<time_t>(random() % 400000), random() % 6, random() % 3 };
+
+            mybank::Authorizer authorizer{ options };
+            authorizer.restore({ true, 1000000000 }, {});
+            mybank::transaction_history referenceTransactions{};
+
+            time_t time{ 1550052000000 };
+            for (auto i{ 0 }; i < 1000; ++i)
+            {
+                time += static_cast<time_t>(random() % 100000) - 40000;
+                const mybank::transaction transaction{ static_cast<int64_t>(1 + random() % 2), "Merchant " + std::to_string(random() % 2), "", time };
+
+                const auto expected{ reference_violations(options.rules, referenceTransactions, transaction) };
+                REQUIRE( authorizer.process(transaction) == expected );
+
+                if (expected.empty())
+                {
+                    referenceTransactions.emplace(transaction.timeInMillis, transaction);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,232 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "catch.hpp"
+
+#include "../include/process_operations/metrics.h"
+#include "../include/process_operations/process_operations.h"
+#include "../include/process_operations/server.h"
+
+namespace
+{
+
+auto connect_unix(const std::string &path) -> int
+{
+    const auto fd{ ::socket(AF_UNIX, SOCK_STREAM, 0) };
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+    return ::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0 ? fd : -1;
+}
+
+auto connect_tcp(uint16_t port) -> int
+{
+    const auto fd{ ::socket(AF_INET, SOCK_STREAM, 0) };
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    return ::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0 ? fd : -1;
+}
+
+// Sends the request and reads until the expected number of output lines arrived
+auto request(int fd, const std::string &lines, std::size_t expectedLines) -> std::string
+{
+    ::send(fd, lines.data(), lines.size(), 0);
+
+    std::string response{};
+    std::size_t receivedLines{ 0 };
+    char buffer[4096];
+    while (receivedLines < expectedLines)
+    {
+        const auto received{ ::read(fd, buffer, sizeof(buffer)) };
+        if (received <= 0)
+        {
+            break;
+        }
+        response.append(buffer, static_cast<std::size_t>(received));
+        receivedLines += static_cast<std::size_t>(std::count(buffer, buffer + received, '\n'));
+    }
+    return response;
+}
+
+} // namespace
+
+TEST_CASE( "Test authorizer server", "[server]" )
+{
+    SECTION( "with several Unix socket connections, then they share the resident account and history" )
+    {
+        const auto socketPath{ (std::filesystem::temp_directory_path() / "mybank_server_test.sock").string() };
+
+        auto server{ mybank::AuthorizerServer::open({ socketPath, 0, 16 }) };
+        REQUIRE( server.has_value() );
+        std::thread serverThread{ [&]() { server->run(); } };
+
+        const auto first{ connect_unix(socketPath) };
+        const auto second{ connect_unix(socketPath) };
+        REQUIRE( first >= 0 );
+        REQUIRE( second >= 0 );
+
+        REQUIRE( request(first, "{\"transaction\":{\"merchant\":\"Burger King\",\"amount\":20,\"time\":\"2019-02-13T10:00:00.000Z\"}}\n"
+                                "{\"account\":{\"activeAccount\":true,\"availableLimit\":100}}\n", 1) ==
+                 "{\"account\":{\"activeAccount\":true,\"availableLimit\":100},\"violations\":[]}\n" );
+
+        REQUIRE( request(second, "not json\n{\"transaction\":{\"merchant\":\"Burger King\",\"amount\":20,\"time\":\"2019-02-13T10:00:00.000Z\"}}\n", 1) ==
+                 "{\"account\":{\"activeAccount\":true,\"availableLimit\":80},\"violations\":[]}\n" );
+
+        REQUIRE( request(first, "{\"transaction\":{\"merchant\":\"Burger King\",\"amount\":20,", 0).empty() );
+        REQUIRE( request(first, "\"time\":\"2019-02-13T10:01:00.000Z\"}}\n{\"account\":{\"activeAccount\":true,\"availableLimit\":5}}\n", 2) ==
+                 "{\"account\":{\"activeAccount\":true,\"availableLimit\":60},\"violations\":[]}\n"
+                 "{\"account\":{\"activeAccount\":true,\"availableLimit\":60},\"violations\":[\"account-already-initialized\"]}\n" );
+
+        REQUIRE( request(second, "{\"transaction\":{\"merchant\":\"Burger King\",\"amount\":20,\"time\":\"2019-02-13T10:01:30.000Z\"}}\n", 1) ==
+                 "{\"account\":{\"activeAccount\":true,\"availableLimit\":60},\"violations\":[\"doubled-transaction\"]}\n" );
+
+        ::close(first);
+        ::close(second);
+
+        server->stop();
+        serverThread.join();
+    }
+
+    SECTION( "with a localhost TCP connection, then each line is answered" )
+    {
+        auto server{ mybank::AuthorizerServer::open({}) };
+        REQUIRE( server.has_value() );
+        REQUIRE( server->port() != 0 );
+        std::thread serverThread{ [&]() { server->run(); } };
+
+        const auto client{ connect_tcp(server->port()) };
+        REQUIRE( client >= 0 );
+
+        REQUIRE( request(client, "{\"account\":{\"activeAccount\":false,\"availableLimit\":100}}\n"
+                                 "{\"transaction\":{\"merchant\":\"Burger King\",\"amount\":20,\"time\":\"2019-02-13T10:00:00.000Z\"}}\n", 2) ==
+                 "{\"account\":{\"activeAccount\":false,\"availableLimit\":100},\"violations\":[]}\n"
+                 "{\"account\":{\"activeAccount\":false,\"availableLimit\":100},\"violations\":[\"account-not-active\"]}\n" );
+
+        ::close(client);
+
+        server->stop();
+        serverThread.join();
+    }
+
+    SECTION( "with a line past the maximum length, then the connection is dropped" )
+    {
+        mybank::server_options options{};
+        options.maxLineLength = 100;
+
+        auto server{ mybank::AuthorizerServer::open(options) };
+        REQUIRE( server.has_value() );
+        std::thread serverThread{ [&]() { server->run(); } };
+
+        const auto client{ connect_tcp(server->port()) };
+        REQUIRE( client >= 0 );
+
+        REQUIRE( request(client, "{\"account\":{\"activeAccount\":true,\"availableLimit\":100}}\n", 1) ==
+                 "{\"account\":{\"activeAccount\":true,\"availableLimit\":100},\"violations\":[]}\n" );
+
+        // Closed without an answer, even though the line never ends, rather than waiting for the rest
+        const timeval timeout{ 5, 0 };
+        ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        const std::string longLine(101, 'x');
+        ::send(client, longLine.data(), longLine.size(), MSG_NOSIGNAL);
+        char buffer[16];
+        REQUIRE( ::read(client, buffer, sizeof(buffer)) == 0 );
+
+        ::close(client);
+
+        server->stop();
+        serverThread.join();
+    }
+
+    SECTION( "with input past the read budget, then the rest is read on later turns of the event loop" )
+    {
+        mybank::server_options options{};
+        options.readBudget = 1000;
+
+        auto server{ mybank::AuthorizerServer::open(options) };
+        REQUIRE( server.has_value() );
+        std::thread serverThread{ [&]() { server->run(); } };
+
+        const auto flooding{ connect_tcp(server->port()) };
+        const auto client{ connect_tcp(server->port()) };
+        REQUIRE( flooding >= 0 );
+        REQUIRE( client >= 0 );
+
+        // Lines without answers, before any account exists
+        std::string invalidLines{};
+        for (auto i{ 0 }; i < 20000; ++i)
+        {
+            invalidLines += "not json\n";
+        }
+        std::thread flooder{ [&]() { ::send(flooding, invalidLines.data(), invalidLines.size(), MSG_NOSIGNAL); } };
+
+        std::string lines{};
+        for (auto i{ 0 }; i < 1000; ++i)
+        {
+            lines += "{\"account\":{\"activeAccount\":true,\"availableLimit\":100}}\n";
+        }
+        const auto response{ request(client, lines, 1000) };
+        flooder.join();
+
+        REQUIRE( std::count(response.begin(), response.end(), '\n') == 1000 );
+
+        ::close(flooding);
+        ::close(client);
+
+        server->stop();
+        serverThread.join();
+    }
+
+    SECTION( "with a client not reading its answers, then the server stops reading past the high-water mark" )
+    {
+        mybank::Metrics metrics{};
+        mybank::process_options processOptions{};
+        processOptions.metrics = &metrics;
+
+        mybank::server_options options{};
+        options.outputHighWaterMark = 64*1024;
+
+        auto server{ mybank::AuthorizerServer::open(options, processOptions) };
+        REQUIRE( server.has_value() );
+        std::thread serverThread{ [&]() { server->run(); } };
+
+        const auto client{ connect_tcp(server->port()) };
+        REQUIRE( client >= 0 );
+
+        // Far more answers than the socket buffers and the high-water mark hold
+        constexpr std::size_t lineCount{ 100000 };
+        std::string lines{};
+        for (std::size_t i{ 0 }; i < lineCount; ++i)
+        {
+            lines += "{\"account\":{\"activeAccount\":true,\"availableLimit\":100}}\n";
+        }
+
+        // Blocks once the server stops reading, until the answers are read below
+        std::thread sender{ [&]() { ::send(client, lines.data(), lines.size(), MSG_NOSIGNAL); } };
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 300 });
+
+        REQUIRE( metrics.snapshot()[mybank::Metric::OPERATIONS] < static_cast<int64_t>(lineCount) );
+
+        const auto response{ request(client, "", lineCount) };
+        sender.join();
+
+        REQUIRE( std::count(response.begin(), response.end(), '\n') == static_cast<std::ptrdiff_t>(lineCount) );
+        REQUIRE( metrics.snapshot()[mybank::Metric::OPERATIONS] == static_cast<int64_t>(lineCount) );
+
+        ::close(client);
+
+        server->stop();
+        serverThread.join();
+    }
+}
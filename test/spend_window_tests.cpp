@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <map>
+#include <memory_resource>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "catch.hpp"
+
+#include "../include/process_operations/process_operations.h"
+#include "../src/spend_window.h"
+
+TEST_CASE( "Test SpendWindow", "[spend_window]" )
+{
+    SECTION( "with transactions in order, then amounts leave the total as they expire" )
+    {
+        mybank::SpendWindow window{ 1000 };
+
+        window.add(0, 10);
+        window.add(500, 20);
+        REQUIRE( window.total_until(999) == 30 );
+        REQUIRE( window.total_until(1000) == 20 );
+
+        window.add(1200, 5);
+        REQUIRE( window.total_until(1500) == 5 );
+        REQUIRE( window.size() == 2 );
+        REQUIRE( window.evictions() == 1 );
+    }
+
+    SECTION( "with late transactions, then those in the window are added to its totals and older ones expire" )
+    {
+        mybank::SpendWindow window{ 1000 };
+
+        window.add(2000, 10);
+        window.add(1500, 20);
+        window.add(500, 40);
+        REQUIRE( window.total_until(2000) == 30 );
+        REQUIRE( window.total_until(2499) == 30 );
+        REQUIRE( window.total_until(2500) == 10 );
+        REQUIRE( window.size() == 2 );
+        REQUIRE( window.evictions() == 1 );
+    }
+
+    SECTION( "with windows reaching back to expired transactions, then no total is returned" )
+    {
+        mybank::SpendWindow window{ 1000 };
+
+        window.add(0, 5);
+        window.add(500, 20);
+        window.add(2000, 10);
+        REQUIRE( !window.total_until(999).has_value() );
+        REQUIRE( !window.total_until(1499).has_value() );
+        REQUIRE( window.total_until(1500) == 0 );
+        REQUIRE( window.total_until(2999) == 10 );
+        REQUIRE( window.size() == 1 );
+        REQUIRE( window.evictions() == 2 );
+    }
+
+    SECTION( "with totals queried past the newest time, then the window does not move" )
+    {
+        mybank::SpendWindow window{ 1000 };
+
+        window.add(0, 5);
+        window.add(500, 20);
+        REQUIRE( window.total_until(1200) == 20 );
+        REQUIRE( window.size() == 2 );
+        REQUIRE( window.evictions() == 0 );
+
+        window.add(100, 40);
+        REQUIRE( window.total_until(999) == 65 );
+    }
+
+    SECTION( "with random transactions, then the totals match a sum of the transactions in the window" )
+    {
+        std::mt19937_64 random{ 20190213 };
+
+        mybank::SpendWindow window{ 1000 };
+        std::multimap<time_t, int64_t> added{};
+        time_t newestTime{ 0 };
+
+        for (auto i{ 0 }; i < 2000; ++i)
+        {
+            const auto time{ newestTime + static_cast<time_t>(random() % 400) - 300 };
+            const auto amount{ static_cast<int64_t>(1 + random() % 100) };
+            window.add(time, amount);
+            added.emplace(time, amount);
+            newestTime = std::max(newestTime, time);
+
+            const auto queried{ newestTime + static_cast<time_t>(random() % 1500) - 1000 };
+            int64_t expected{ 0 };
+            for (auto transaction{ added.upper_bound(queried - 1000) }; transaction != added.upper_bound(queried); ++transaction)
+            {
+                expected += transaction->second;
+            }
+
+            const auto total{ window.total_until(queried) };
+            REQUIRE( (total.has_value() || queried < newestTime) );
+            REQUIRE( (!total.has_value() || total.value() == expected) );
+            REQUIRE( window.size() + window.evictions() == added.size() );
+        }
+    }
+
+    SECTION( "with a memory resource, then the transactions are allocated from it" )
+    {
+        std::pmr::monotonic_buffer_resource resource{};
+        // Allocating from the default resource would fail
+        auto *previous{ std::pmr::set_default_resource(std::pmr::null_memory_resource()) };
+
+        mybank::SpendWindow window{ 1000, &resource };
+        window.add(2000, 10);
+        window.add(1500, 20);
+
+        std::pmr::set_default_resource(previous);
+        REQUIRE( window.total_until(2000) == 30 );
+    }
+}
+
+TEST_CASE( "Test spend velocity", "[spend_window]" )
+{
+    SECTION( "with a spend limit over an hour, then a transaction taking the total past it is rejected" )
+    {
+        constexpr auto inputTransactions{
+            R"({"account":{"activeAccount":true,"availableLimit":1000}}
+               {"transaction":{"merchant":"Burger King","amount":100,"time":"2019-02-13T10:00:00.000Z"}}
+               {"transaction":{"merchant":"Habbib's","amount":150,"time":"2019-02-13T10:30:00.000Z"}}
+               {"transaction":{"merchant":"McDonald's","amount":60,"time":"2019-02-13T10:59:59.999Z"}}
+               {"transaction":{"merchant":"Subway","amount":50,"time":"2019-02-13T09:40:00.000Z"}}
+               {"transaction":{"merchant":"McDonald's","amount":60,"time":"2019-02-13T11:00:00.000Z"}})"
+        };
+        constexpr auto outputTransactions{
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":1000},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":900},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":750},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":750},\"violations\":[\"spend-velocity\"]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":700},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":640},\"violations\":[]}\n"
+        };
+
+        mybank::process_options options{};
+        options.rules.spendWindowMillis = 60*60*1000;
+        options.rules.maxSpendInWindow = 300;
+
+        std::istringstream input{ inputTransactions };
+        std::ostringstream output;
+        mybank::process_operations(input, output, options);
+
+        REQUIRE( output.str() == outputTransactions );
+    }
+
+    SECTION( "with random out of order transactions, then violations match a sum over the history" )
+    {
+        std::mt19937_64 random{ 20190213 };
+
+        mybank::process_options options{};
+        options.rules.smallIntervalMillis = 0;
+        options.rules.spendWindowMillis = 10*60*1000;
+        options.rules.maxSpendInWindow = 1500;
+
+        mybank::Authorizer authorizer{ options };
+        authorizer.restore({ true, 1000000000 }, {});
+        mybank::transaction_history referenceTransactions{};
+
+        time_t time{ 1550052000000 };
+        for (auto i{ 0 }; i < 5000; ++i)
+        {
+            time += (random() % 10 == 0) ? -static_cast<time_t>(random() % 1200000) : static_cast<time_t>(random() % 60000);
+            const mybank::transaction transaction{ static_cast<int64_t>(1 + random() % 200), "Burger King", "", time };
+
+            auto spent{ transaction.amount };
+            for (const auto &[t, validTransaction] : referenceTransactions)
+            {
+                if (t > time - options.rules.spendWindowMillis && t <= time)
+                {
+                    spent += validTransaction.amount;
+                }
+            }
+            const auto expected{ spent > options.rules.maxSpendInWindow };
+
+            const auto &violations{ authorizer.process(transaction) };
+            REQUIRE( violations.empty() != expected );
+
+            if (!expected)
+            {
+                referenceTransactions.emplace(transaction.timeInMillis, transaction);
+            }
+        }
+    }
+}
@@ -0,0 +1,129 @@
+#include <cmath>
+#include <deque>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "../include/process_operations/process_operations.h"
+#include "../src/time_buckets.h"
+
+namespace
+{
+
+// The history scan the frequency check used before the time buckets
+auto reference_high_frequency(
+        const mybank::transaction_history &validTransactions,
+        const mybank::transaction &transaction)
+        -> bool
+{
+    constexpr auto smallInterval{ 2*60*1000 };
+
+    double timediff;
+    auto maxTransactionsSmallInterval{ 0 };
+    std::deque<mybank::transaction> transactionsSmallInterval{};
+    for (auto crit{ validTransactions.crbegin() };
+         crit != validTransactions.crend() &&
+         (timediff = difftime(transaction.timeInMillis, crit->first)) < smallInterval;
+         ++crit)
+    {
+        if (fabs(timediff) < smallInterval)
+        {
+            transactionsSmallInterval.push_back(crit->second);
+            while (difftime(transactionsSmallInterval.front().timeInMillis, crit->first) > smallInterval)
+            {
+                transactionsSmallInterval.pop_front();
+            }
+
+            const auto currTransactionsSmallInterval{ static_cast<int>(transactionsSmallInterval.size()) };
+            if (currTransactionsSmallInterval > maxTransactionsSmallInterval)
+            {
+                maxTransactionsSmallInterval = currTransactionsSmallInterval;
+            }
+        }
+    }
+
+    return maxTransactionsSmallInterval > 2;
+}
+
+} // namespace
+
+TEST_CASE( "Test TimeBuckets", "[time_buckets]" )
+{
+    SECTION( "with times in and out of the ring, then only covered buckets are counted" )
+    {
+        mybank::TimeBuckets buckets{ 1000, 4 };
+
+        buckets.add(10500);
+        buckets.add(10999);
+        buckets.add(12000);
+
+        REQUIRE( buckets.count(10) == 2 );
+        REQUIRE( buckets.count(11) == 0 );
+        REQUIRE( buckets.count(12) == 1 );
+        REQUIRE( buckets.count(13) == 0 );
+
+        buckets.add(14000);
+        REQUIRE( !buckets.covers(10) );
+        REQUIRE( buckets.covers(11) );
+        REQUIRE( buckets.count(14) == 1 );
+
+        buckets.add(9000);
+        REQUIRE( buckets.count(11) == 0 );
+
+        buckets.add(100000);
+        REQUIRE( buckets.count(14) == 0 );
+        REQUIRE( buckets.count(100) == 1 );
+    }
+
+    SECTION( "with times before the epoch, then buckets are rounded down" )
+    {
+        mybank::TimeBuckets buckets{ 1000, 4 };
+
+        REQUIRE( buckets.bucket_of(-1) == -1 );
+        REQUIRE( buckets.bucket_of(-1000) == -1 );
+        REQUIRE( buckets.bucket_of(-1001) == -2 );
+        REQUIRE( buckets.bucket_start(-2) == -2000 );
+    }
+}
+
+TEST_CASE( "Test high frequency check against the history scan", "[time_buckets]" )
+{
+    std::mt19937_64 random{ 20190213 };
+
+    // Dense bursts, late arrivals, exact interval edges and jumps past the whole ring
+    for (auto run{ 0 }; run < 50; ++run)
+    {
+        mybank::Authorizer authorizer{};
+        authorizer.restore({ true, 1000000000 }, {});
+        mybank::transaction_history referenceTransactions{};
+
+        time_t time{ 1550052000000 };
+        for (auto i{ 0 }; i < 2000; ++i)
+        {
+            switch (random() % 8)
+            {
+                case 0: time += 120000; break;
+                case 1: time -= 120000; break;
+                case 2: time += static_cast<time_t>(random() % 1000); break;
+                case 3: time -= static_cast<time_t>(random() % 300000); break;
+                case 4: time += 600000 + static_cast<time_t>(random() % 600000); break;
+                default: time += static_cast<time_t>(random() % 60000); break;
+            }
+
+            // Distinct amounts so only the frequency check can reject
+            const mybank::transaction transaction{ 1 + i, "Burger King", "", time };
+            const auto expected{ reference_high_frequency(referenceTransactions, transaction) };
+
+            const auto &violations{ authorizer.process(transaction) };
+            const auto highFrequency{ !violations.empty() && violations.back() == mybank::Violation::HIGH_FREQUENCY_SMALL_INTERVAL };
+
+            REQUIRE( highFrequency == expected );
+            if (violations.empty())
+            {
+                referenceTransactions.emplace(transaction.timeInMillis, transaction);
+            }
+        }
+    }
+}
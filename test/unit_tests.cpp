@@ -190,4 +190,29 @@ TEST_CASE( "Test process_transactions", "[process_transactions]" )
         REQUIRE( account.availableLimit == 20 );
         REQUIRE( output.str() == outputUnorderedTransactions );
     }
+
+    SECTION( "with malformed lines and mistyped fields, then they are handled without throwing" )
+    {
+        constexpr auto inputMalformedTransactions{
+            R"({"transaction":{"merchant":"Burger King","amount":20,"time":"2019-02-13T10:00:00.000Z"
+               {"transaction":{"merchant":7,"amount":20,"time":"2019-02-13T10:00:00.000Z"}}
+               {"transaction":{"merchant":"Burger King","amount":20,"time":false}}
+               {"transaction":{"merchant":"Burger King","amount":20,"time":"2019-02-13T10:00:00.000Z"}})"
+        };
+        constexpr auto outputMalformedTransactions{
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":100},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":100},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":80},\"violations\":[]}\n"
+        };
+
+        mybank::account account{ true, 100 };
+
+        std::istringstream input{ inputMalformedTransactions };
+        std::ostringstream output;
+
+        mybank::process_transactions(account, input, output);
+
+        REQUIRE( account.availableLimit == 80 );
+        REQUIRE( output.str() == outputMalformedTransactions );
+    }
 }
@@ -0,0 +1,158 @@
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "catch.hpp"
+
+#include "../include/process_operations/process_operations.h"
+#include "../include/process_operations/uring_streams.h"
+#include "../src/io_uring.h"
+#include "generate_operations.h"
+
+namespace
+{
+
+auto temporary_file(const std::string &name, const std::string &content) -> std::string
+{
+    const auto path{ (std::filesystem::temp_directory_path() / ("mybank_" + name)).string() };
+    std::ofstream{ path, std::ios::trunc } << content;
+    return path;
+}
+
+auto read_file(const std::string &path) -> std::string
+{
+    std::ifstream file{ path };
+    return std::string{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+}
+
+} // namespace
+
+TEST_CASE( "Test process_operations over io_uring stream buffers", "[uring_streams]" )
+{
+    const auto inputOperations{ mybank::test::generate_operations(3000) };
+
+    std::istringstream input{ inputOperations };
+    std::ostringstream output;
+    mybank::process_operations(input, output);
+
+    SECTION( "with regular files and small buffers, then output is the same as with iostreams" )
+    {
+        const auto inputPath{ temporary_file("uring_input.txt", inputOperations) };
+        const auto outputPath{ temporary_file("uring_output.txt", "") };
+
+        const auto inputFd{ ::open(inputPath.c_str(), O_RDONLY) };
+        const auto outputFd{ ::open(outputPath.c_str(), O_WRONLY | O_TRUNC) };
+        REQUIRE( inputFd >= 0 );
+        REQUIRE( outputFd >= 0 );
+
+        REQUIRE( mybank::process_operations(inputFd, outputFd, {}, { 3, 4093 }) );
+
+        ::close(inputFd);
+        ::close(outputFd);
+
+        REQUIRE( read_file(outputPath) == output.str() );
+    }
+
+    SECTION( "with pipes, then output is the same as with iostreams" )
+    {
+        int inputPipe[2];
+        int outputPipe[2];
+        REQUIRE( ::pipe(inputPipe) == 0 );
+        REQUIRE( ::pipe(outputPipe) == 0 );
+
+        std::thread producer{ [&]() {
+            for (std::size_t written{ 0 }; written < inputOperations.size();)
+            {
+                const auto result{ ::write(inputPipe[1], inputOperations.data() + written,
+                                           std::min<std::size_t>(1000, inputOperations.size() - written)) };
+                written += result > 0 ? static_cast<std::size_t>(result) : 0;
+            }
+            ::close(inputPipe[1]);
+        } };
+
+        std::string pipedOutput{};
+        std::thread consumer{ [&]() {
+            char buffer[4096];
+            for (ssize_t received; (received = ::read(outputPipe[0], buffer, sizeof(buffer))) > 0;)
+            {
+                pipedOutput.append(buffer, static_cast<std::size_t>(received));
+            }
+        } };
+
+        mybank::process_operations(inputPipe[0], outputPipe[1], {}, { 2, 512 });
+        ::close(outputPipe[1]);
+
+        producer.join();
+        consumer.join();
+        ::close(inputPipe[0]);
+        ::close(outputPipe[0]);
+
+        REQUIRE( pipedOutput == output.str() );
+    }
+
+    SECTION( "with a read error, then the stream is bad rather than at its end" )
+    {
+        // Reading a directory fails with EISDIR
+        const auto inputFd{ ::open(std::filesystem::temp_directory_path().c_str(), O_RDONLY | O_DIRECTORY) };
+        const auto outputFd{ ::open("/dev/null", O_WRONLY) };
+        REQUIRE( inputFd >= 0 );
+        REQUIRE( outputFd >= 0 );
+
+        {
+            mybank::UringInputStreambuf inputBuffer{ inputFd };
+            std::istream in{ &inputBuffer };
+            std::string line;
+            REQUIRE( !std::getline(in, line) );
+            REQUIRE( inputBuffer.failed() );
+        }
+
+        REQUIRE( !mybank::process_operations(inputFd, outputFd) );
+
+        ::close(inputFd);
+        ::close(outputFd);
+
+        const auto emptyFd{ ::open("/dev/null", O_RDONLY) };
+        REQUIRE( emptyFd >= 0 );
+        {
+            mybank::UringInputStreambuf inputBuffer{ emptyFd };
+            std::istream in{ &inputBuffer };
+            std::string line;
+            REQUIRE( !std::getline(in, line) );
+            REQUIRE( !inputBuffer.failed() );
+        }
+        ::close(emptyFd);
+    }
+
+    SECTION( "with the operations the kernel was probed for, then io_uring is only used when it can read and write" )
+    {
+        const auto ring{ mybank::IoUring::create(2) };
+        const auto canRead{ ring.has_value() && (ring->supports(IORING_OP_READ) || ring->supports(IORING_OP_READ_FIXED)) };
+        const auto canWrite{ ring.has_value() && (ring->supports(IORING_OP_WRITE) || ring->supports(IORING_OP_WRITE_FIXED)) };
+
+        if (ring.has_value() && (canRead || canWrite))
+        {
+            // No-ops exist since the first io_uring kernels, opcodes past the last one never do
+            REQUIRE( ring->supports(IORING_OP_NOP) );
+            REQUIRE( !ring->supports(255) );
+        }
+
+        const auto inputFd{ ::open("/dev/null", O_RDONLY) };
+        const auto outputFd{ ::open("/dev/null", O_WRONLY) };
+        REQUIRE( inputFd >= 0 );
+        REQUIRE( outputFd >= 0 );
+
+        mybank::UringInputStreambuf inputBuffer{ inputFd };
+        mybank::UringOutputStreambuf outputBuffer{ outputFd };
+        REQUIRE( inputBuffer.uses_io_uring() == canRead );
+        REQUIRE( outputBuffer.uses_io_uring() == canWrite );
+
+        ::close(inputFd);
+        ::close(outputFd);
+    }
+}
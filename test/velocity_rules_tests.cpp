@@ -0,0 +1,220 @@
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "catch.hpp"
+
+#include "../include/process_operations/process_operations.h"
+
+namespace
+{
+
+auto run_operations(const std::string &inputOperations, const mybank::rule_options &rules) -> std::string
+{
+    mybank::process_options options{};
+    options.rules = rules;
+
+    std::istringstream input{ inputOperations };
+    std::ostringstream output;
+    mybank::process_operations(input, output, options);
+    return output.str();
+}
+
+// Velocity violations of a transaction by scanning the whole history for every rule
+auto reference_velocity_violations(
+        const std::vector<mybank::velocity_rule> &rules,
+        const mybank::transaction_history &validTransactions,
+        const mybank::transaction &transaction)
+        -> std::vector<mybank::Violation>
+{
+    const auto matches = [](const mybank::velocity_rule &rule, const mybank::transaction &t) {
+        return (rule.merchant.empty() || rule.merchant == t.merchant) && t.amount >= rule.minAmount && t.amount <= rule.maxAmount;
+    };
+
+    auto countExceeded{ false };
+    auto amountExceeded{ false };
+    for (const auto &rule : rules)
+    {
+        if (!matches(rule, transaction))
+        {
+            continue;
+        }
+
+        std::size_t count{ 1 };
+        auto amount{ transaction.amount };
+        for (const auto &[time, t] : validTransactions)
+        {
+            if (time > transaction.timeInMillis - rule.windowMillis && time <= transaction.timeInMillis &&
+                matches(rule, t) && (!rule.eachMerchant || t.merchant == transaction.merchant))
+            {
+                ++count;
+                amount += t.amount;
+            }
+        }
+
+        countExceeded = countExceeded || count > rule.maxTransactions;
+        amountExceeded = amountExceeded || amount > rule.maxAmountSum;
+    }
+
+    std::vector<mybank::Violation> violations{};
+    if (countExceeded)
+    {
+        violations.push_back(mybank::Violation::VELOCITY_COUNT_LIMIT);
+    }
+    if (amountExceeded)
+    {
+        violations.push_back(mybank::Violation::VELOCITY_AMOUNT_LIMIT);
+    }
+    return violations;
+}
+
+} // namespace
+
+TEST_CASE( "Test velocity rules", "[velocity_rules]" )
+{
+    SECTION( "with a merchant count rule, then a third transaction at the merchant in 10 minutes is rejected" )
+    {
+        constexpr auto inputTransactions{
+            R"({"account":{"activeAccount":true,"availableLimit":100}}
+               {"transaction":{"merchant":"Burger King","amount":10,"time":"2019-02-13T10:00:00.000Z"}}
+               {"transaction":{"merchant":"Burger King","amount":11,"time":"2019-02-13T10:05:00.000Z"}}
+               {"transaction":{"merchant":"Burger King","amount":12,"time":"2019-02-13T10:09:59.999Z"}}
+               {"transaction":{"merchant":"Habbib's","amount":13,"time":"2019-02-13T10:09:59.999Z"}}
+               {"transaction":{"merchant":"Burger King","amount":14,"time":"2019-02-13T10:10:00.000Z"}})"
+        };
+        constexpr auto outputTransactions{
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":100},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":90},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":79},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":79},\"violations\":[\"velocity-count-limit\"]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":66},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":52},\"violations\":[]}\n"
+        };
+
+        mybank::rule_options rules{};
+        rules.velocityRules.push_back({ "Burger King" });
+        rules.velocityRules.back().maxTransactions = 2;
+
+        REQUIRE( run_operations(inputTransactions, rules) == outputTransactions );
+    }
+
+    SECTION( "with an amount sum rule and a count rule per merchant in an amount band, then both are reported" )
+    {
+        constexpr auto inputTransactions{
+            R"({"account":{"activeAccount":true,"availableLimit":1000}}
+               {"transaction":{"merchant":"Burger King","amount":150,"time":"2019-02-13T10:00:00.000Z"}}
+               {"transaction":{"merchant":"Habbib's","amount":150,"time":"2019-02-13T10:10:00.000Z"}}
+               {"transaction":{"merchant":"Burger King","amount":50,"time":"2019-02-13T10:20:00.000Z"}}
+               {"transaction":{"merchant":"Burger King","amount":120,"time":"2019-02-13T10:30:00.000Z"}}
+               {"transaction":{"merchant":"Burger King","amount":100,"time":"2019-02-13T11:05:00.000Z"}})"
+        };
+        constexpr auto outputTransactions{
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":1000},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":850},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":700},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":650},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":650},\"violations\":[\"velocity-count-limit\",\"velocity-amount-limit\"]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":550},\"violations\":[]}\n"
+        };
+
+        mybank::rule_options rules{};
+        rules.velocityRules.push_back({});
+        rules.velocityRules.back().windowMillis = 60*60*1000;
+        rules.velocityRules.back().maxAmountSum = 400;
+        rules.velocityRules.push_back({ "", true, 100 });
+        rules.velocityRules.back().windowMillis = 60*60*1000;
+        rules.velocityRules.back().maxTransactions = 1;
+
+        REQUIRE( run_operations(inputTransactions, rules) == outputTransactions );
+    }
+
+    SECTION( "with velocity rules in a rules file, then they are loaded" )
+    {
+        const auto path{ (std::filesystem::temp_directory_path() / "mybank_velocity_rules.json").string() };
+        std::ofstream{ path } << R"({"velocityRules":[{"merchant":"Burger King","windowMillis":600000,"maxTransactions":3},)"
+                              << R"({"eachMerchant":true,"minAmount":100,"maxAmountSum":1000}]})";
+
+        const auto rules{ mybank::load_rule_options(path) };
+
+        REQUIRE( rules.has_value() );
+        REQUIRE( rules->velocityRules.size() == 2 );
+        REQUIRE( rules->velocityRules[0].merchant == "Burger King" );
+        REQUIRE( rules->velocityRules[0].maxTransactions == 3 );
+        REQUIRE( rules->velocityRules[1].eachMerchant );
+        REQUIRE( rules->velocityRules[1].minAmount == 100 );
+        REQUIRE( rules->velocityRules[1].maxAmountSum == 1000 );
+        REQUIRE( rules->velocityRules[1].windowMillis == 10*60*1000 );
+    }
+
+    SECTION( "with a velocity rule window past maxWindowMillis in a rules file, then it is rejected" )
+    {
+        const auto path{ (std::filesystem::temp_directory_path() / "mybank_velocity_rules.json").string() };
+        const auto load = [&path](const std::string &windowMillis) {
+            std::ofstream{ path } << R"({"velocityRules":[{"windowMillis":)" << windowMillis << "}]}";
+            return mybank::load_rule_options(path);
+        };
+
+        REQUIRE( load(std::to_string(mybank::maxWindowMillis))->velocityRules[0].windowMillis == mybank::maxWindowMillis );
+        REQUIRE( !load(std::to_string(mybank::maxWindowMillis + 1)).has_value() );
+        REQUIRE( !load("9223372036854775807").has_value() );
+    }
+
+    SECTION( "with a velocity rule window past maxWindowMillis set in code, then it is clamped to it" )
+    {
+        constexpr auto inputTransactions{
+            R"({"account":{"activeAccount":true,"availableLimit":100}}
+               {"transaction":{"merchant":"Burger King","amount":10,"time":"2019-02-13T10:00:00.000Z"}}
+               {"transaction":{"merchant":"Burger King","amount":10,"time":"3029-02-13T10:00:00.000Z"}}
+               {"transaction":{"merchant":"Burger King","amount":10,"time":"3929-02-13T10:00:00.000Z"}})"
+        };
+        constexpr auto outputTransactions{
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":100},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":90},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":80},\"violations\":[]}\n"
+            "{\"account\":{\"activeAccount\":true,\"availableLimit\":80},\"violations\":[\"velocity-count-limit\"]}\n"
+        };
+
+        mybank::rule_options rules{};
+        rules.velocityRules.push_back({});
+        rules.velocityRules.back().windowMillis = std::numeric_limits<time_t>::max();
+        rules.velocityRules.back().maxTransactions = 1;
+
+        REQUIRE( run_operations(inputTransactions, rules) == outputTransactions );
+    }
+
+    SECTION( "with random out of order transactions, then violations match a scan of the history" )
+    {
+        std::mt19937_64 random{ 20190213 };
+
+        mybank::process_options options{};
+        options.rules.smallIntervalMillis = 0;
+        options.rules.velocityRules = {
+            { "Merchant 0", false, 1, 50, 5*60*1000, 4 },
+            { "", true, 40, 100, 20*60*1000, 6, 900 },
+            { "", false, 1, 100, 60*60*1000, 40, 2500 }
+        };
+
+        mybank::Authorizer authorizer{ options };
+        authorizer.restore({ true, 1000000000 }, {});
+        mybank::transaction_history referenceTransactions{};
+
+        time_t time{ 1550052000000 };
+        for (auto i{ 0 }; i < 3000; ++i)
+        {
+            time += static_cast<time_t>(random() % 120000) - 30000;
+            const mybank::transaction transaction{
+                static_cast<int64_t>(1 + random() % 100), "Merchant " + std::to_string(random() % 3), "", time };
+
+            const auto expected{ reference_velocity_violations(options.rules.velocityRules, referenceTransactions, transaction) };
+            REQUIRE( authorizer.process(transaction) == expected );
+
+            if (expected.empty())
+            {
+                referenceTransactions.emplace(transaction.timeInMillis, transaction);
+            }
+        }
+    }
+}
@@ -0,0 +1,246 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "../include/process_operations/process_operations.h"
+#include "../include/process_operations/write_ahead_log.h"
+
+namespace
+{
+
+auto temporary_path(const std::string &name) -> std::string
+{
+    const auto path{ std::filesystem::temp_directory_path() / ("mybank_" + name) };
+    std::filesystem::remove(path);
+    return path.string();
+}
+
+auto count_lines(const std::string &path) -> std::size_t
+{
+    std::ifstream file{ path };
+    std::size_t lines{ 0 };
+    for (std::string line; std::getline(file, line);)
+    {
+        ++lines;
+    }
+    return lines;
+}
+
+} // namespace
+
+TEST_CASE( "Test write-ahead log", "[write_ahead_log]" )
+{
+    constexpr auto inputOperations{
+        R"({"account":{"activeAccount":true,"availableLimit":100}}
+           {"transaction":{"merchant":"Burger King","amount":20,"time":"2019-02-13T10:00:00.000Z"}}
+           {"transaction":{"merchant":"Habbib's","amount":200,"time":"2019-02-13T10:00:30.000Z"}}
+           {"transaction":{"merchant":"Habbib's","amount":30,"time":"2019-02-13T10:01:00.000Z"}})"
+    };
+
+    SECTION( "with group commit, then only accepted changes are logged and recovered" )
+    {
+        const auto walPath{ temporary_path("group_commit.wal") };
+
+        {
+            auto wal{ mybank::WriteAheadLog::open({ walPath, 2, std::chrono::seconds{ 60 } }) };
+            REQUIRE( wal.has_value() );
+
+            std::istringstream input{ inputOperations };
+            std::ostringstream output;
+
+            mybank::process_operations(input, output, { &wal.value() });
+
+            REQUIRE( wal->sequence() == 3 );
+            REQUIRE( count_lines(walPath) == 3 );
+        }
+
+        const auto state{ mybank::recover_state(temporary_path("missing.checkpoint"), walPath) };
+
+        REQUIRE( state.has_value() );
+        REQUIRE( state->account.has_value() );
+        REQUIRE( state->account->availableLimit == 50 );
+        REQUIRE( state->validTransactions.size() == 2 );
+        REQUIRE( state->walSequence == 3 );
+    }
+
+    SECTION( "with pending records, then they are written only when the group is committed" )
+    {
+        const auto walPath{ temporary_path("pending.wal") };
+
+        auto wal{ mybank::WriteAheadLog::open({ walPath, 3, std::chrono::seconds{ 60 } }) };
+        REQUIRE( wal.has_value() );
+
+        wal->append(mybank::account{ true, 100 });
+        wal->append(mybank::transaction{ 10, "Burger King", "2019-02-13T10:00:00.000Z", 0 });
+        REQUIRE( count_lines(walPath) == 0 );
+
+        wal->append(mybank::transaction{ 10, "Burger King", "2019-02-13T10:00:10.000Z", 0 });
+        REQUIRE( count_lines(walPath) == 3 );
+    }
+
+    SECTION( "with no records arriving after one, then it is committed once the interval expires" )
+    {
+        const auto walPath{ temporary_path("idle.wal") };
+
+        auto wal{ mybank::WriteAheadLog::open({ walPath, 64, std::chrono::milliseconds{ 20 } }) };
+        REQUIRE( wal.has_value() );
+
+        REQUIRE( wal->append(mybank::account{ true, 100 }) );
+        REQUIRE( count_lines(walPath) == 0 );
+
+        for (auto tries{ 0 }; tries < 200 && count_lines(walPath) == 0; ++tries)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+        }
+        REQUIRE( count_lines(walPath) == 1 );
+    }
+
+    SECTION( "with a failing device, then the failure is returned and the records stay pending" )
+    {
+        if (!std::filesystem::exists("/dev/full"))
+        {
+            return;
+        }
+
+        auto wal{ mybank::WriteAheadLog::open({ "/dev/full", 1, std::chrono::seconds{ 60 } }) };
+        REQUIRE( wal.has_value() );
+
+        REQUIRE( !wal->append(mybank::account{ true, 100 }) );
+        REQUIRE( wal->sequence() == 1 );
+
+        // Still failing with the same record, where a dropped group would have nothing left to commit
+        REQUIRE( !wal->commit() );
+        REQUIRE( !wal->commit() );
+    }
+
+    SECTION( "with checkpoint, then only records after it are replayed and a torn tail is ignored" )
+    {
+        const auto walPath{ temporary_path("checkpoint.wal") };
+        const auto checkpointPath{ temporary_path("state.checkpoint") };
+
+        mybank::account account{ true, 100 };
+        mybank::transaction_history validTransactions{};
+
+        {
+            auto wal{ mybank::WriteAheadLog::open({ walPath, 1, std::chrono::microseconds{ 0 } }) };
+            REQUIRE( wal.has_value() );
+
+            std::istringstream input{ inputOperations };
+            std::ostringstream output;
+
+            mybank::process_transactions(account, validTransactions, input, output, { &wal.value() });
+            REQUIRE( mybank::write_checkpoint(checkpointPath, account, validTransactions, wal->sequence()) );
+
+            std::istringstream moreInput{
+                R"({"transaction":{"merchant":"Burger King","amount":5,"time":"2019-02-13T10:05:00.000Z"}})" };
+            mybank::process_transactions(account, validTransactions, moreInput, output, { &wal.value() });
+        }
+
+        std::ofstream{ walPath, std::ios::app } << R"({"seq":4,"transaction":{"merchant":"Bur)";
+
+        const auto state{ mybank::recover_state(checkpointPath, walPath) };
+
+        REQUIRE( state.has_value() );
+        REQUIRE( state->account.has_value() );
+        REQUIRE( state->account->availableLimit == account.availableLimit );
+        REQUIRE( state->account->availableLimit == 45 );
+        REQUIRE( state->validTransactions.size() == 3 );
+        REQUIRE( state->walSequence == 3 );
+    }
+
+    SECTION( "with a torn tail, then reopening cuts it off and the next record is recovered" )
+    {
+        const auto walPath{ temporary_path("torn.wal") };
+
+        {
+            auto wal{ mybank::WriteAheadLog::open({ walPath, 1, std::chrono::microseconds{ 0 } }) };
+            REQUIRE( wal.has_value() );
+            REQUIRE( wal->append(mybank::account{ true, 100 }) );
+            REQUIRE( wal->append(mybank::transaction{ 10, "Burger King", "2019-02-13T10:00:00.000Z", 1550052000000 }) );
+        }
+
+        std::ofstream{ walPath, std::ios::app } << R"({"seq":3,"transaction":{"merchant":"Bur)";
+
+        {
+            auto wal{ mybank::WriteAheadLog::open({ walPath, 1, std::chrono::microseconds{ 0 } }) };
+            REQUIRE( wal.has_value() );
+            REQUIRE( wal->sequence() == 2 );
+            REQUIRE( wal->append(mybank::transaction{ 20, "Habbib's", "2019-02-13T10:01:00.000Z", 1550052060000 }) );
+        }
+
+        const auto state{ mybank::recover_state(temporary_path("missing.checkpoint"), walPath) };
+
+        REQUIRE( state.has_value() );
+        REQUIRE( state->account->availableLimit == 70 );
+        REQUIRE( state->validTransactions.size() == 2 );
+        REQUIRE( state->walSequence == 3 );
+    }
+
+    SECTION( "with a record missing from the sequence, then recovery fails" )
+    {
+        const auto walPath{ temporary_path("gap.wal") };
+
+        std::ofstream{ walPath }
+                << R"({"seq":1,"account":{"activeAccount":true,"availableLimit":100}})" << '\n'
+                << R"({"seq":3,"transaction":{"amount":10,"merchant":"Burger King","time":"2019-02-13T10:00:00.000Z"}})" << '\n';
+
+        REQUIRE( !mybank::recover_state(temporary_path("missing.checkpoint"), walPath).has_value() );
+
+        std::ofstream{ walPath }
+                << R"({"seq":1,"account":{"activeAccount":true,"availableLimit":100}})" << '\n'
+                << "not a record" << '\n'
+                << R"({"seq":2,"transaction":{"amount":10,"merchant":"Burger King","time":"2019-02-13T10:00:00.000Z"}})" << '\n';
+
+        REQUIRE( !mybank::recover_state(temporary_path("missing.checkpoint"), walPath).has_value() );
+    }
+
+    SECTION( "with concurrent appenders, then every record has its own sequence" )
+    {
+        const auto walPath{ temporary_path("concurrent.wal") };
+
+        {
+            auto wal{ mybank::WriteAheadLog::open({ walPath, 16, std::chrono::milliseconds{ 1 } }) };
+            REQUIRE( wal.has_value() );
+            REQUIRE( wal->append(mybank::account{ true, 1000000 }) );
+
+            std::vector<std::thread> appenders{};
+            for (auto i{ 0 }; i < 4; ++i)
+            {
+                appenders.emplace_back([&wal, i]() {
+                    for (auto j{ 0 }; j < 250; ++j)
+                    {
+                        const auto timeInMillis{ 1550052000000 + (i*250 + j)*1000 };
+                        wal->append(mybank::transaction{ 1, "Burger King", "", timeInMillis });
+                    }
+                });
+            }
+            for (auto &appender : appenders)
+            {
+                appender.join();
+            }
+            REQUIRE( wal->commit() );
+        }
+
+        const auto state{ mybank::recover_state(temporary_path("missing.checkpoint"), walPath) };
+
+        REQUIRE( state.has_value() );
+        REQUIRE( state->walSequence == 1001 );
+        REQUIRE( state->account->availableLimit == 1000000 - 1000 );
+    }
+
+    SECTION( "with a log moved from, then appending to it fails" )
+    {
+        auto wal{ mybank::WriteAheadLog::open({ temporary_path("moved.wal"), 1, std::chrono::microseconds{ 0 } }) };
+        REQUIRE( wal.has_value() );
+
+        auto moved{ std::move(wal.value()) };
+        REQUIRE( !wal->append(mybank::account{ true, 100 }) );
+        REQUIRE( !wal->commit() );
+        REQUIRE( moved.append(mybank::account{ true, 100 }) );
+    }
+}